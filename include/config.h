@@ -44,6 +44,7 @@ public:
         this->showPlayerView = false;
         this->showCursorTile = true;
         this->monitorFiles = true;
+        this->cacheBudgetMB = 1024;
         this->regionMapDimensions = QSize(32, 20);
         this->theme = "default";
         this->textEditorOpenFolder = "";
@@ -61,6 +62,7 @@ public:
     void setShowPlayerView(bool enabled);
     void setShowCursorTile(bool enabled);
     void setMonitorFiles(bool monitor);
+    void setCacheBudgetMB(int megabytes);
     void setRegionMapDimensions(int width, int height);
     void setTheme(QString theme);
     void setTextEditorOpenFolder(const QString& command);
@@ -77,6 +79,7 @@ public:
     bool getShowPlayerView();
     bool getShowCursorTile();
     bool getMonitorFiles();
+    int getCacheBudgetMB();
     QSize getRegionMapDimensions();
     QString getTheme();
     QString getTextEditorOpenFolder();
@@ -111,6 +114,7 @@ private:
     bool showPlayerView;
     bool showCursorTile;
     bool monitorFiles;
+    int cacheBudgetMB;
     QSize regionMapDimensions;
     QString theme;
     QString textEditorOpenFolder;
@@ -148,6 +152,8 @@ public:
     }
     void setBaseGameVersion(BaseGameVersion baseGameVersion);
     BaseGameVersion getBaseGameVersion();
+    // Configures a project without a porymap.project.cfg for the given base game, without creating the file.
+    void loadDefaults(const QString& baseGameVersion);
     void setRecentMap(const QString& map);
     QString getRecentMap();
     void setEncounterJsonActive(bool active);
@@ -5,6 +5,7 @@
 #include "block.h"
 
 #include <QByteArray>
+#include <QRect>
 #include <QVector>
 
 class Blockdata : public QVector<Block> {
@@ -12,4 +13,53 @@ public:
     QByteArray serialize() const;
 };
 
+/// A single changed block, identified by its index into a Blockdata.
+struct BlockChange {
+    int index;
+    Block oldBlock;
+    Block newBlock;
+};
+
+/// A run of consecutive changed blocks, beginning at index 'start' of a Blockdata.
+struct BlockSpan {
+    int start;
+    QVector<Block> oldBlocks;
+    QVector<Block> newBlocks;
+};
+
+/// Record of the blocks changed by an edit, so that edit history only needs
+/// to hold what was actually painted rather than the whole map.
+/// Changed blocks are kept as runs of consecutive blocks, or as full copies
+/// of the blockdata before and after the edit if most of the map changed.
+class BlockdataDiff {
+public:
+    BlockdataDiff() = default;
+    BlockdataDiff(const Blockdata& oldBlocks, const Blockdata& newBlocks);
+
+    void record(int index, Block oldBlock, Block newBlock);
+    void compact();
+    void merge(const BlockdataDiff& later);
+    void applyNew(Blockdata* blocks) const;
+    void applyOld(Blockdata* blocks) const;
+    QRect boundingRect(int width) const;
+    qint64 memoryUsage() const;
+
+    bool isEmpty() const {
+        return changes.isEmpty() && spans.isEmpty() && !snapshot;
+    }
+
+private:
+    QVector<BlockChange> toChanges() const;
+    void setChanges(const QVector<BlockChange>& sortedChanges);
+
+    // Changes recorded since the last compact(), in the order they were made.
+    QVector<BlockChange> changes;
+    QVector<BlockSpan> spans;
+    bool compacted = true;
+
+    bool snapshot = false;
+    Blockdata oldSnapshot;
+    Blockdata newSnapshot;
+};
+
 #endif // BLOCKDATA_H
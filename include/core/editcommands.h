@@ -40,9 +40,10 @@ enum CommandId {
 
 /// Implements a command to commit metatile paint actions
 /// onto the map using the pencil tool.
+/// Only the changed blocks are stored, so memory scales with what was painted.
 class PaintMetatile : public QUndoCommand {
 public:
-    PaintMetatile(Map* map, const Blockdata& oldMetatiles, const Blockdata& newMetatiles, unsigned actionId, QUndoCommand* parent = nullptr);
+    PaintMetatile(Map* map, const BlockdataDiff& changes, unsigned actionId, QUndoCommand* parent = nullptr);
 
     void undo() override;
     void redo() override;
@@ -51,12 +52,14 @@ public:
     int id() const override {
         return CommandId::ID_PaintMetatile;
     }
+    qint64 memoryUsage() const {
+        return sizeof(*this) + changes.memoryUsage();
+    }
 
 private:
     Map* map;
 
-    Blockdata newMetatiles;
-    Blockdata oldMetatiles;
+    BlockdataDiff changes;
 
     unsigned actionId;
 };
@@ -65,8 +68,8 @@ private:
 /// on the metatile collision and elevation.
 class PaintCollision : public PaintMetatile {
 public:
-    PaintCollision(Map* map, const Blockdata& oldCollision, const Blockdata& newCollision, unsigned actionId, QUndoCommand* parent = nullptr)
-        : PaintMetatile(map, oldCollision, newCollision, actionId, parent) {
+    PaintCollision(Map* map, const BlockdataDiff& changes, unsigned actionId, QUndoCommand* parent = nullptr)
+        : PaintMetatile(map, changes, actionId, parent) {
         setText("Paint Collision");
     }
 
@@ -89,6 +92,9 @@ public:
     int id() const override {
         return CommandId::ID_PaintBorder;
     }
+    qint64 memoryUsage() const {
+        return sizeof(*this) + qint64(oldBorder.capacity() + newBorder.capacity()) * sizeof(Block);
+    }
 
 private:
     Map* map;
@@ -103,8 +109,8 @@ private:
 /// with the bucket tool onto the map.
 class BucketFillMetatile : public PaintMetatile {
 public:
-    BucketFillMetatile(Map* map, const Blockdata& oldMetatiles, const Blockdata& newMetatiles, unsigned actionId, QUndoCommand* parent = nullptr)
-        : PaintMetatile(map, oldMetatiles, newMetatiles, actionId, parent) {
+    BucketFillMetatile(Map* map, const BlockdataDiff& changes, unsigned actionId, QUndoCommand* parent = nullptr)
+        : PaintMetatile(map, changes, actionId, parent) {
         setText("Bucket Fill Metatiles");
     }
 
@@ -117,8 +123,7 @@ public:
 /// on the metatile collision and elevation.
 class BucketFillCollision : public PaintCollision {
 public:
-    BucketFillCollision(Map* map, const Blockdata& oldCollision, const Blockdata& newCollision, QUndoCommand* parent = nullptr)
-        : PaintCollision(map, oldCollision, newCollision, -1, parent) {
+    BucketFillCollision(Map* map, const BlockdataDiff& changes, QUndoCommand* parent = nullptr) : PaintCollision(map, changes, -1, parent) {
         setText("Flood Fill Collision");
     }
 
@@ -134,8 +139,8 @@ public:
 /// with the bucket or paint tool onto the map.
 class MagicFillMetatile : public PaintMetatile {
 public:
-    MagicFillMetatile(Map* map, const Blockdata& oldMetatiles, const Blockdata& newMetatiles, unsigned actionId, QUndoCommand* parent = nullptr)
-        : PaintMetatile(map, oldMetatiles, newMetatiles, actionId, parent) {
+    MagicFillMetatile(Map* map, const BlockdataDiff& changes, unsigned actionId, QUndoCommand* parent = nullptr)
+        : PaintMetatile(map, changes, actionId, parent) {
         setText("Magic Fill Metatiles");
     }
 
@@ -147,8 +152,7 @@ public:
 /// Implements a command to commit magic fill collision actions.
 class MagicFillCollision : public PaintCollision {
 public:
-    MagicFillCollision(Map* map, const Blockdata& oldCollision, const Blockdata& newCollision, QUndoCommand* parent = nullptr)
-        : PaintCollision(map, oldCollision, newCollision, -1, parent) {
+    MagicFillCollision(Map* map, const BlockdataDiff& changes, QUndoCommand* parent = nullptr) : PaintCollision(map, changes, -1, parent) {
         setText("Magic Fill Collision");
     }
 
@@ -163,7 +167,7 @@ public:
 /// Implements a command to commit metatile shift actions.
 class ShiftMetatiles : public QUndoCommand {
 public:
-    ShiftMetatiles(Map* map, const Blockdata& oldMetatiles, const Blockdata& newMetatiles, unsigned actionId, QUndoCommand* parent = nullptr);
+    ShiftMetatiles(Map* map, const BlockdataDiff& changes, unsigned actionId, QUndoCommand* parent = nullptr);
 
     void undo() override;
     void redo() override;
@@ -172,12 +176,14 @@ public:
     int id() const override {
         return CommandId::ID_ShiftMetatiles;
     }
+    qint64 memoryUsage() const {
+        return sizeof(*this) + changes.memoryUsage();
+    }
 
 private:
     Map* map;
 
-    Blockdata newMetatiles;
-    Blockdata oldMetatiles;
+    BlockdataDiff changes;
 
     unsigned actionId;
 };
@@ -197,6 +203,10 @@ public:
     int id() const override {
         return CommandId::ID_ResizeMap;
     }
+    qint64 memoryUsage() const {
+        qint64 blocks = oldMetatiles.capacity() + newMetatiles.capacity() + oldBorder.capacity() + newBorder.capacity();
+        return sizeof(*this) + blocks * sizeof(Block);
+    }
 
 private:
     Map* map;
@@ -314,6 +324,8 @@ class ScriptEditMap : public QUndoCommand {
 public:
     ScriptEditMap(
         Map* map, QSize oldMapDimensions, QSize newMapDimensions, const Blockdata& oldMetatiles, const Blockdata& newMetatiles, QUndoCommand* parent = nullptr);
+    // For edits that don't resize the map, only the changed blocks are stored.
+    ScriptEditMap(Map* map, const BlockdataDiff& changes, QUndoCommand* parent = nullptr);
 
     void undo() override;
     void redo() override;
@@ -324,10 +336,15 @@ public:
     int id() const override {
         return CommandId::ID_ScriptEditMap;
     }
+    qint64 memoryUsage() const {
+        return sizeof(*this) + changes.memoryUsage() + qint64(oldMetatiles.capacity() + newMetatiles.capacity()) * sizeof(Block);
+    }
 
 private:
     Map* map;
 
+    bool resized;
+    BlockdataDiff changes;
     Blockdata newMetatiles;
     Blockdata oldMetatiles;
 
@@ -22,6 +22,15 @@ public:
     static QString HealLocation;
 };
 
+class EventGroup {
+public:
+    static QString Object;
+    static QString Warp;
+    static QString Coord;
+    static QString Bg;
+    static QString Heal;
+};
+
 class DraggablePixmapItem;
 class Project;
 class Event {
@@ -31,39 +40,37 @@ public:
     Event(QJsonObject, QString);
 
 public:
+    // The values of "event_type" and "event_group_type", for comparisons that don't need the strings.
+    enum class Kind { Unknown, Object, Warp, Trigger, WeatherTrigger, Sign, HiddenItem, SecretBase, HealLocation };
+    enum class Group { Unknown, Object, Warp, Coord, Bg, Heal };
+
     int x() const {
-        return getInt("x");
+        return posX;
     }
     int y() const {
-        return getInt("y");
+        return posY;
     }
-    int elevation() {
-        return getInt("elevation");
+    int elevation() const {
+        return posElevation;
     }
     void setX(int x) {
-        put("x", x);
+        posX = x;
     }
     void setY(int y) {
-        put("y", y);
+        posY = y;
     }
-    QString get(const QString& key) const {
-        return values.value(key);
+    Kind kind() const {
+        return eventKind;
     }
-    int getInt(const QString& key) const {
-        return values.value(key).toInt(nullptr, 0);
-    }
-    uint16_t getU16(const QString& key) const {
-        return values.value(key).toUShort(nullptr, 0);
-    }
-    int16_t getS16(const QString& key) const {
-        return values.value(key).toShort(nullptr, 0);
-    }
-    void put(QString key, int value) {
-        put(key, QString("%1").arg(value));
-    }
-    void put(QString key, QString value) {
-        values.insert(key, value);
+    Group group() const {
+        return eventGroup;
     }
+    QString get(const QString& key) const;
+    int getInt(const QString& key) const;
+    uint16_t getU16(const QString& key) const;
+    int16_t getS16(const QString& key) const;
+    void put(const QString& key, int value);
+    void put(const QString& key, const QString& value);
 
     static Event* createNewEvent(QString, QString, Project*);
     static Event* createNewObjectEvent(Project*);
@@ -83,6 +90,7 @@ public:
     OrderedJson::object buildHiddenItemEventJSON();
     OrderedJson::object buildSecretBaseEventJSON();
     void setPixmapFromSpritesheet(QImage, int, int, int, bool);
+    void setSpritePixmap(const QPixmap&, int, int);
     int getPixelX();
     int getPixelY();
     QMap<QString, bool> getExpectedFields();
@@ -103,6 +111,17 @@ public:
     void setPixmapItem(DraggablePixmapItem* item) {
         pixmapItem = item;
     }
+
+private:
+    // Position and type are read constantly while drawing and dragging events, so they're kept out of 'values'.
+    // get() and put() still accept their keys.
+    int posX = 0;
+    int posY = 0;
+    int posElevation = 0;
+    QString eventType;
+    QString eventGroupType;
+    Kind eventKind = Kind::Unknown;
+    Group eventGroup = Group::Unknown;
 };
 
 #endif // EVENT_H
@@ -0,0 +1,40 @@
+#pragma once
+#ifndef GIFWRITER_H
+#define GIFWRITER_H
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QRect>
+#include <QVector>
+
+struct GifFileType;
+
+// Writes an animated GIF to disk one frame at a time, so frames don't have to be kept in memory.
+// All frames share a single global color table, and each frame may cover only the part of the
+// canvas that changed since the previous frame.
+class GifWriter {
+public:
+    GifWriter() = default;
+    ~GifWriter();
+
+    bool open(const QString& filepath, const QSize& size, const QVector<QRgb>& colorTable, int loopCount = 0);
+    // Writes the given rect of the image at the same position on the canvas.
+    bool writeFrame(const QImage& image, const QRect& rect, int delayMs);
+    bool close();
+    QString errorString() const {
+        return this->error;
+    }
+
+private:
+    QFile file;
+    GifFileType* gif = nullptr;
+    QVector<QRgb> colorTable;
+    QHash<QRgb, uchar> colorIndexes;
+    QString error;
+
+    uchar getColorIndex(QRgb color);
+    bool fail(const QString& message);
+};
+
+#endif // GIFWRITER_H
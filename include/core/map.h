@@ -9,10 +9,13 @@
 #include "event.h"
 
 #include <QUndoStack>
+#include <QHash>
 #include <QPixmap>
 #include <QObject>
 #include <QGraphicsPixmapItem>
+#include <QPainter>
 #include <math.h>
+#include <functional>
 
 #define DEFAULT_BORDER_WIDTH 2
 #define DEFAULT_BORDER_HEIGHT 2
@@ -68,21 +71,41 @@ public:
     static QString warpEventsLabelFromName(QString mapName);
     static QString coordEventsLabelFromName(QString mapName);
     static QString bgEventsLabelFromName(QString mapName);
-    int getWidth();
-    int getHeight();
-    int getBorderWidth();
-    int getBorderHeight();
-    QPixmap render(bool ignoreCache, MapLayout* fromLayout = nullptr);
-    QPixmap renderCollision(qreal opacity, bool ignoreCache);
-    bool mapBlockChanged(int i, const Blockdata& cache);
+    int getWidth() const;
+    int getHeight() const;
+    int getBorderWidth() const;
+    int getBorderHeight() const;
+    QPixmap render(MapLayout* fromLayout = nullptr);
+    QPixmap renderCollision(qreal opacity);
+    // Paint the given rect of blocks (in metatile coordinates) at their map position.
+    void paintBlocks(QPainter* painter, const QRect& blockRect, MapLayout* fromLayout = nullptr);
+    void paintCollisionBlocks(QPainter* painter, const QRect& blockRect, qreal opacity);
     bool borderBlockChanged(int i, const Blockdata& cache);
-    void cacheBlockdata();
-    void cacheCollision();
-    bool getBlock(int x, int y, Block* out);
-    void setBlock(int x, int y, Block block, bool enableScriptCallback = false);
-    void floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation);
-    void _floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation);
-    void magicFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation);
+    // Blocks that changed since the map views last drew, in metatile coordinates.
+    // Only these are repainted unless a full redraw is requested.
+    void markBlocksDirty(const QRect& rect);
+    void markBlocksDirty(const BlockdataDiff& changes);
+    void markAllBlocksDirty();
+    QRect takeDirtyMetatileRect();
+    QRect takeDirtyCollisionRect();
+    // Same as above, but for consumers outside the map views (e.g. the timelapse exporter).
+    QRect takeChangedBlocksRect();
+    bool isWithinBounds(int x, int y) const;
+    bool getBlock(int x, int y, Block* out) const;
+    void setBlock(int x, int y, Block block, bool enableScriptCallback = false, BlockdataDiff* changes = nullptr);
+    // Unchecked variants for tight loops. The caller must ensure (x, y) is within the map bounds.
+    Block getBlockUnchecked(int x, int y) const;
+    void setBlockUnchecked(int x, int y, Block block);
+    // Raw block values for every block in rect, row by row. Blocks outside the map read as 0 and are not written.
+    QVector<uint16_t> getRawBlocks(const QRect& rect) const;
+    void setRawBlocks(const QRect& rect, const QVector<uint16_t>& rawValues, QVector<uint16_t>* prevValues = nullptr);
+    // Blockdata indices of the blocks that 'matches' accepts and that are connected to (x, y) through them horizontally
+    // or vertically, for the fill tools. Found by a scanline fill with a visited bitset, in time linear in the region's size.
+    // Nothing is changed, so the caller can modify the region afterwards.
+    QVector<int> getConnectedBlocks(int x, int y, const std::function<bool(const Block&)>& matches) const;
+    void floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation, BlockdataDiff* changes = nullptr);
+    void _floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation, BlockdataDiff* changes = nullptr);
+    void magicFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation, BlockdataDiff* changes = nullptr);
     QList<Event*> getAllEvents() const;
     QStringList eventScriptLabels(const QString& event_group_type = QString()) const;
     void removeEvent(Event*);
@@ -93,6 +116,18 @@ public:
     void setBorderDimensions(int newWidth, int newHeight, bool setNewBlockdata = true);
     void cacheBorder();
     bool hasUnsavedChanges();
+    // Identifies everything saved from the map apart from its layout, so the map cache can tell whether
+    // it was edited outside of the undo history (e.g. in the header or event property panels).
+    QByteArray contentHash() const;
+    QByteArray savedContentHash;
+    quint64 savedBlocksRevision = 0;
+    // Records the map's current contents as what was last loaded or saved.
+    void markSaved();
+    // True if anything saved from the map changed since it was last loaded or saved, including edits
+    // made outside of the undo history.
+    bool needsSave();
+    // Roughly how much memory the map's images and undo history use, not counting its layout.
+    qint64 memoryUsage() const;
 
     // for memory management
     QVector<Event*> ownedEvents;
@@ -115,6 +150,24 @@ public:
     QUndoStack editHistory;
 
 private:
+    QRect dirtyMetatileRect;
+    QRect dirtyCollisionRect;
+    QRect changedBlocksRect;
+
+    // The strips of this map last shown as connections of a neighboring map, keyed by direction.
+    struct ConnectionStrip {
+        QRect blockRect;
+        MapLayout* layout;
+        quint64 blocksRevision;
+        Tileset* primaryTileset;
+        Tileset* secondaryTileset;
+        quint64 primaryRevision;
+        quint64 secondaryRevision;
+        QList<int> layerOrder;
+        QList<float> layerOpacity;
+        QPixmap pixmap;
+    };
+    QHash<QString, ConnectionStrip> connectionStrips;
     void setNewDimensionsBlockdata(int newWidth, int newHeight);
     void setNewBorderDimensionsBlockdata(int newWidth, int newHeight);
 
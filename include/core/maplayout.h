@@ -13,12 +13,16 @@ public:
     MapLayout() {
     }
     static QString layoutConstantFromName(QString mapName);
+    // Roughly how much memory the blockdata, border and their images use.
+    qint64 memoryUsage() const;
+    // Frees the blockdata, border and border images. They're read again when a map using the layout is loaded.
+    void releaseData();
     QString id;
     QString name;
-    QString width;
-    QString height;
-    QString border_width;
-    QString border_height;
+    int width = 0;
+    int height = 0;
+    int border_width = 0;
+    int border_height = 0;
     QString border_path;
     QString blockdata_path;
     QString tileset_primary_label;
@@ -29,13 +33,23 @@ public:
     QImage border_image;
     QPixmap border_pixmap;
     Blockdata border;
-    Blockdata cached_blockdata;
-    Blockdata cached_collision;
     Blockdata cached_border;
     struct {
         Blockdata blocks;
         QSize dimensions;
     } lastCommitMapBlocks; // to track map changes
+
+    // Identifies the current blocks, border and dimensions. Must be refreshed with markBlocksChanged()
+    // whenever any map using the layout edits them, or they're reloaded, so that caches of rendered
+    // blocks (e.g. connection strips) built from the old contents are not reused.
+    quint64 blocksRevision() const {
+        return this->blocksRevision_;
+    }
+    void markBlocksChanged();
+
+private:
+    static quint64 nextBlocksRevision();
+    quint64 blocksRevision_ = nextBlocksRevision();
 };
 
 #endif // MAPLAYOUT_H
@@ -8,34 +8,12 @@
 #include <QString>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QDateTime>
+#include <QMutex>
+#include <QThreadStorage>
 #include <QRegularExpression>
 
-enum TokenClass {
-    Number,
-    Operator,
-    Error,
-};
-
-class Token {
-public:
-    Token(QString value = "", QString type = "") {
-        this->value = value;
-        this->type = TokenClass::Operator;
-        if (type == "decimal" || type == "hex") {
-            this->type = TokenClass::Number;
-            this->operatorPrecedence = -1;
-        } else if (type == "operator") {
-            this->operatorPrecedence = precedenceMap[value];
-        } else if (type == "error") {
-            this->type = TokenClass::Error;
-        }
-    }
-    static QMap<QString, int> precedenceMap;
-    QString value;
-    TokenClass type;
-    int operatorPrecedence; // only relevant for operator tokens
-};
-
 class ParseUtil {
 public:
     ParseUtil(){};
@@ -43,11 +21,14 @@ public:
     static QString readTextFile(const QString& path);
     static int textFileLineCount(const QString& path);
     QList<QStringList> parseAsm(const QString& filename);
-    int evaluateDefine(const QString&, const QMap<QString, int>&);
+    int evaluateDefine(const QString&, const QHash<QString, int>&);
     QStringList readCArray(const QString& text, const QString& label);
     QMap<QString, QString> readNamedIndexCArray(const QString& text, const QString& label);
     QString readCIncbin(const QString& text, const QString& label);
-    QMap<QString, int> readCDefines(const QString& filename, const QStringList& prefixes, QMap<QString, int> = {});
+    // Read every array or INCBIN in a file in one pass, keyed by label.
+    QHash<QString, QStringList> readCArrays(const QString& filename);
+    QHash<QString, QString> readCIncbins(const QString& filename);
+    QMap<QString, int> readCDefines(const QString& filename, const QStringList& prefixes, const QMap<QString, int>& = {});
     QStringList readCDefinesSorted(const QString&, const QStringList&, const QMap<QString, int>& = {});
     QList<QStringList> getLabelMacros(const QList<QStringList>&, const QString&);
     QStringList getLabelValues(const QList<QStringList>&, const QString&);
@@ -65,14 +46,41 @@ public:
 
     static QStringList splitShellCommand(QStringView command);
 
+    // Files read by parseAsm, readCDefines, readCArray and readCIncbin are cached until they change on disk.
+    // The cache is shared between threads, so independent files can be parsed concurrently.
+    void invalidateFile(const QString& path);
+    void clearFileCache();
+
 private:
     QString root;
-    QString text;
-    QString file;
-    QList<Token> tokenizeExpression(QString expression, const QMap<QString, int>& knownIdentifiers);
-    QList<Token> generatePostfix(const QList<Token>& tokens);
-    int evaluatePostfix(const QList<Token>& postfix);
+
+    // The file currently being parsed by this thread, for error messages.
+    struct ErrorContext {
+        QString file;
+        QString text;
+    };
+    QThreadStorage<ErrorContext> errorContext;
+
+    struct CachedFile {
+        QDateTime lastModified;
+        qint64 size = -1;
+        QString text;
+        bool asmParsed = false;
+        QList<QStringList> asmMacros;
+        bool definesParsed = false;
+        QList<QPair<QString, QString>> defineExpressions;
+    };
+    QHash<QString, CachedFile> fileCache;
+    QMutex fileCacheMutex;
+    CachedFile getCachedFile(const QString& path);
+    void storeCachedFile(const QString& path, const CachedFile& cached);
+
+    // Cursor over a define's expression, consumed by the evaluator below in a single pass.
+    struct DefineExpression;
+    int evaluateBinary(DefineExpression& expr, int minPrecedence);
+    int evaluateUnary(DefineExpression& expr);
     void error(const QString& message, const QString& expression);
+    static QStringList splitCArrayBody(const QString& body);
 };
 
 #endif // PARSEUTIL_H
@@ -9,8 +9,11 @@
 class Tileset {
 public:
     Tileset() = default;
-    Tileset(const Tileset& other) = default;
-    Tileset& operator=(const Tileset& other) = default;
+    // Copies get their own metatiles and a new revision, so editing a copy never changes the original
+    // or the images cached for it.
+    Tileset(const Tileset& other);
+    Tileset& operator=(const Tileset& other);
+    ~Tileset();
 
 public:
     QString name;
@@ -28,7 +31,10 @@ public:
     QImage tilesImage;
     QStringList palettePaths;
 
-    QList<QImage> tiles;
+    // Palette indices of every 8x8 tile in tilesImage, one byte per pixel. Tiles are stored
+    // contiguously in row-major order (64 bytes each) so metatiles can be composed directly.
+    QByteArray tilePixels;
+    // Owned by the tileset. Delete the old ones when replacing them.
     QList<Metatile*> metatiles;
     QList<QList<QRgb>> palettes;
     QList<QList<QRgb>> palettePreviews;
@@ -39,9 +45,30 @@ public:
     static QList<QRgb> getPalette(int, Tileset*, Tileset*, bool useTruePalettes = false);
     static bool metatileIsValid(uint16_t metatileId, Tileset*, Tileset*);
 
+    int tileCount() const {
+        return this->tilePixels.size() / 64;
+    }
+    // Returns the 64 palette indices of the given tile, or nullptr if it doesn't exist.
+    const uchar* getTilePixels(int localIndex) const;
+
+    // Identifies the current contents of the tiles, metatiles and palettes.
+    // Must be refreshed with markChanged() whenever any of them are edited,
+    // so that cached metatile images built from the old contents are not reused.
+    quint64 revision() const {
+        return this->revision_;
+    }
+    void markChanged();
+
+    // Roughly how much memory the decoded tiles, metatiles and palettes use.
+    qint64 memoryUsage() const;
+
     bool appendToHeaders(QString headerFile, QString friendlyName);
     bool appendToGraphics(QString graphicsFile, QString friendlyName, bool primary);
     bool appendToMetatiles(QString metatileFile, QString friendlyName, bool primary);
+
+private:
+    static quint64 nextRevision();
+    quint64 revision_ = nextRevision();
 };
 
 #endif // TILESET_H
@@ -111,7 +111,7 @@ public:
     QGraphicsPathItem* connection_mask = nullptr;
     CollisionPixmapItem* collision_item = nullptr;
     QGraphicsItemGroup* events_group = nullptr;
-    QList<QGraphicsPixmapItem*> borderItems;
+    QGraphicsRectItem* border_item = nullptr;
     QList<QGraphicsLineItem*> gridLines;
     MovableRect* playerViewRect = nullptr;
     CursorTileRect* cursorMapTileRect = nullptr;
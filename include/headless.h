@@ -0,0 +1,45 @@
+#pragma once
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+#include <QImage>
+#include <QElapsedTimer>
+
+class Project;
+class Map;
+
+// Renders and checks a project without creating any windows, for build pipelines and benchmarks.
+// Started with `porymap --headless <project>`. Runs on the offscreen platform unless QT_QPA_PLATFORM says otherwise.
+class Headless {
+public:
+    static bool isRequested(int argc, char* argv[]);
+    static int run(const QStringList& arguments);
+
+private:
+    explicit Headless(Project* project);
+
+    Project* project;
+    QString outputDir;
+    bool showCollision = false;
+    QElapsedTimer phaseTimer;
+    QList<QPair<QString, qint64>> timings;
+
+    void endPhase(const QString& name);
+    void printTimings();
+
+    bool openProject(const QString& dir, const QString& baseGame);
+    bool loadProject(const QString& dir, const QString& baseGame);
+    int checkProject();
+    QStringList checkMetatileIds(Map* map);
+
+    QImage renderMap(Map* map);
+    QImage renderStitch(Map* startMap);
+    QImage renderTilesets(const QString& primaryLabel, const QString& secondaryLabel);
+    bool saveImage(const QImage& image, const QString& filename);
+};
+
+#endif // HEADLESS_H
@@ -224,8 +224,11 @@ public:
 
     void dump(QFile* file) {
         QTextStream fileStream(file);
-        fileStream << m_obj->dump(&m_indent);
-        fileStream << "\n"; // pad file with newline
+        fileStream << toString();
+    }
+
+    QString toString() {
+        return m_obj->dump(&m_indent) + "\n"; // pad file with newline
     }
 
 private:
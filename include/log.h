@@ -7,6 +7,7 @@
 #include <QFile>
 #include <QTextStream>
 #include <QString>
+#include <QStringList>
 #include <QDebug>
 
 enum LogType {
@@ -19,6 +20,10 @@ void logInfo(QString message);
 void logWarn(QString message);
 void logError(QString message);
 void log(QString message, LogType type);
+// Waits until every queued message has been written to the log file.
+void flushLog();
+// Returns the recent log lines added after the first `*since` lines were logged, and updates `*since`.
+QStringList getRecentLogLines(quint64* since);
 QString getLogPath();
 QString getMostRecentError();
 bool cleanupLargeLog();
@@ -24,6 +24,9 @@
 #include "newtilesetdialog.h"
 #include "shortcutseditor.h"
 #include "preferenceeditor.h"
+#include "logviewer.h"
+
+class EventPropertiesFrame;
 
 namespace Ui {
 class MainWindow;
@@ -45,6 +48,8 @@ public:
     void tryRedrawMapArea(bool forceRedraw);
     void tryCommitMapChanges(bool commitChanges);
     Q_INVOKABLE void setBlock(int x, int y, int tile, int collision, int elevation, bool forceRedraw = true, bool commitChanges = true);
+    Q_INVOKABLE QJSValue getBlocks(int x, int y, int width, int height);
+    Q_INVOKABLE void setBlocks(int x, int y, int width, int height, QJSValue rawValues, bool forceRedraw = true, bool commitChanges = true);
     Q_INVOKABLE void setBlocksFromSelection(int x, int y, bool forceRedraw = true, bool commitChanges = true);
     Q_INVOKABLE int getMetatileId(int x, int y);
     Q_INVOKABLE void setMetatileId(int x, int y, int metatileId, bool forceRedraw = true, bool commitChanges = true);
@@ -222,6 +227,7 @@ private slots:
     void on_toolButton_CollapseAll_clicked();
     void on_actionAbout_Porymap_triggered();
     void on_actionOpen_Log_File_triggered();
+    void on_actionShow_Log_triggered();
     void on_actionOpen_Config_Folder_triggered();
     void on_pushButton_AddCustomHeaderField_clicked();
     void on_pushButton_DeleteCustomHeaderField_clicked();
@@ -238,12 +244,14 @@ private slots:
 private:
     Ui::MainWindow* ui;
     QLabel* label_MapRulerStatus = nullptr;
+    QLabel* label_CacheUsage = nullptr;
     QPointer<TilesetEditor> tilesetEditor = nullptr;
     QPointer<RegionMapEditor> regionMapEditor = nullptr;
     QPointer<ShortcutsEditor> shortcutsEditor = nullptr;
     QPointer<MapImageExporter> mapImageExporter = nullptr;
     QPointer<NewMapPopup> newmapprompt = nullptr;
     QPointer<PreferenceEditor> preferenceEditor = nullptr;
+    QPointer<LogViewer> logViewer = nullptr;
     FilterChildrenProxyModel* mapListProxyModel;
     QStandardItemModel* mapListModel;
     QList<QStandardItem*>* mapGroupItemsList;
@@ -272,6 +280,16 @@ private:
     QList<QAction*> registeredActions;
     QVector<QToolButton*> openScriptButtons;
 
+    // Event property frames are kept per event type and rebound on each selection, instead of being rebuilt.
+    QMap<QString, QList<EventPropertiesFrame*>> eventFramePool;
+    QList<EventPropertiesFrame*> boundEventFrames;
+    QStringListModel* scriptLabelsModel = nullptr;
+    EventPropertiesFrame* takeEventFrame(const QString& eventType);
+    EventPropertiesFrame* createEventFrame(const QString& eventType);
+    void bindEventFrame(EventPropertiesFrame* frame, DraggablePixmapItem* item, bool showIndex);
+    void releaseEventFrames();
+    void clearEventFramePool();
+
     bool isProgrammaticEventTabChange;
     bool projectHasUnsavedChanges;
     bool projectOpenFailure = false;
@@ -289,6 +307,7 @@ private:
     bool openProject(QString dir);
     QString getDefaultMap();
     void setRecentMap(QString map_name);
+    void trimProjectCaches();
     QStandardItem* createMapItem(QString mapName, int groupNum, int inGroupNum);
 
     void drawMapListIcons(QAbstractItemModel* model);
@@ -15,12 +15,24 @@
 #include <QVector>
 #include <QPair>
 #include <QStandardItem>
+#include <QStringListModel>
 #include <QVariant>
 #include <QFileSystemWatcher>
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <QAtomicInt>
 
 static QString NONE_MAP_CONSTANT = "MAP_NONE";
 static QString NONE_MAP_NAME = "None";
 
+// The few map.json fields needed to sort the map list, so it can be built without loading every map.
+struct MapHeaderIndexEntry {
+    QDateTime lastModified;
+    QString layoutId;
+    QString location;
+};
+
 class Project : public QObject {
     Q_OBJECT
 public:
@@ -66,6 +78,12 @@ public:
     QMap<QString, int> metatileBehaviorMap;
     QMap<int, QString> metatileBehaviorMapInverse;
     QMap<QString, QString> facingDirections;
+
+    // Models for combo boxes that list one of the constant lists above ("flags", "vars", "items", "maps",
+    // "movement_types", "trainer_types", "coord_event_weather", "secret_bases", "bg_event_facing_directions",
+    // "object_event_graphics" or "species"). They're shared by every combo box, and only change when the lists do.
+    QStringListModel* getListModel(const QString& name);
+    void updateListModels();
     ParseUtil parser;
     QFileSystemWatcher fileWatcher;
     QMap<QString, qint64> modifiedFileTimestamps;
@@ -91,6 +109,12 @@ public:
     QMap<QString, Tileset*> tilesetCache;
     Tileset* loadTileset(QString, Tileset* tileset = nullptr);
     Tileset* getTileset(QString, bool forceLoad = false);
+
+    // Unloads the least recently used maps and tilesets until the caches fit in the memory budget
+    // (porymapConfig's cache_budget_mb). Maps with unsaved changes, the maps in pinnedMaps and the tilesets
+    // of any loaded map are kept. Anything unloaded is read again by getMap/getTileset when next needed.
+    void evictCaches(const QStringList& pinnedMaps);
+    qint64 getCacheMemoryUsage();
     QMap<QString, QStringList> tilesetLabels;
 
     Blockdata readBlockdata(QString);
@@ -98,8 +122,16 @@ public:
 
     void saveTextFile(QString path, QString text);
     void appendTextFile(QString path, QString text);
+    // Replaces the file at path through a temporary file, unless it already has these contents.
+    // Returns true if the file was written.
+    bool writeFile(const QString& path, const QByteArray& data);
     void deleteFile(QString path);
 
+    bool readDataStructures();
+    void cancelReadingDataStructures();
+    // How long each reader took during the last readDataStructures, in milliseconds.
+    QList<QPair<QString, qint64>> dataStructureReadTimes;
+
     bool readMapGroups();
     Map* addNewMapToGroup(QString mapName, int groupNum);
     Map* addNewMapToGroup(QString, int, Map*, bool);
@@ -108,6 +140,7 @@ public:
 
     QString readMapLayoutId(QString map_name);
     QString readMapLocation(QString map_name);
+    void updateMapHeaderIndex();
 
     bool readWildMonData();
     tsl::ordered_map<QString, tsl::ordered_map<QString, WildPokemonHeader>> wildMonData;
@@ -118,6 +151,8 @@ public:
 
     bool readSpeciesIconPaths();
     QMap<QString, QString> speciesToIconPath;
+    // Species icons are decoded on first use and kept until the species are re-read.
+    QPixmap getSpeciesIcon(const QString& species);
 
     QMap<QString, bool> getTopLevelMapFields();
     bool loadMapData(Map*);
@@ -139,7 +174,7 @@ public:
     void saveMapGroups();
     void saveWildMonData();
     void saveMapConstantsHeader();
-    void saveHealLocationStruct(Map*);
+    void saveHealLocations();
     void saveTilesets(Tileset*, Tileset*);
     void saveTilesetMetatileLabels(Tileset*, Tileset*);
     void saveTilesetMetatileAttributes(Tileset*);
@@ -171,6 +206,7 @@ public:
     bool readMiscellaneousConstants();
 
     void loadEventPixmaps(QList<Event*> objects);
+    void clearEventGraphics();
     QMap<QString, int> getEventObjGfxConstants();
     QString fixPalettePath(QString path);
     QString fixGraphicPath(QString path);
@@ -210,6 +246,36 @@ private:
     void setNewMapConnections(Map* map);
 
     void ignoreWatchedFileTemporarily(QString filepath);
+    void watchFile(const QString& filepath);
+
+    QAtomicInt readingCanceled;
+
+    // When each cached map and tileset was last used, for evictCaches.
+    quint64 cacheUseCounter = 0;
+    QHash<QString, quint64> mapLastUsed;
+    QHash<QString, quint64> tilesetLastUsed;
+
+    QHash<QString, MapHeaderIndexEntry> mapHeaderIndex;
+
+    QMap<QString, QStringListModel*> listModels;
+    QHash<QString, QPixmap> speciesIcons;
+    QStringList getListModelStrings(const QString& name);
+
+    // Object event graphics keyed by graphics id, read from the object event headers in one pass.
+    // Spritesheets and their frames are decoded on first use and shared by every map.
+    struct EventGraphics {
+        QString spritesheetPath;
+        int spriteWidth = 0;
+        int spriteHeight = 0;
+        bool spritesheetLoaded = false;
+        QImage spritesheet;
+        QHash<int, QPixmap> framePixmaps;
+    };
+    QHash<QString, EventGraphics> eventGraphics;
+    // Decoded spritesheets are dropped when their file changes, so edited sprites show up on the next map load.
+    QSet<QString> watchedSpritesheets;
+    bool eventGraphicsRead = false;
+    void readEventGraphics();
 
     static int num_tiles_primary;
     static int num_tiles_total;
@@ -225,6 +291,7 @@ signals:
     void reloadProject();
     void uncheckMonitorFilesAction();
     void mapCacheCleared();
+    void dataStructuresReadProgress(int finished, int total);
 };
 
 #endif // PROJECT_H
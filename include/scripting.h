@@ -12,6 +12,7 @@ enum CallbackType {
     OnProjectOpened,
     OnProjectClosed,
     OnBlockChanged,
+    OnBlocksChanged,
     OnMapOpened,
 };
 
@@ -28,6 +29,10 @@ public:
     static void cb_ProjectOpened(QString projectPath);
     static void cb_ProjectClosed(QString projectPath);
     static void cb_MetatileChanged(int x, int y, Block prevBlock, Block newBlock);
+    static void cb_BlocksChanged(const QRect& rect, const QVector<uint16_t>& prevValues, const QVector<uint16_t>& newValues);
+    static bool hasCallback(CallbackType type);
+    static QJSValue toUint16Array(const QVector<uint16_t>& values);
+    static QVector<uint16_t> fromUint16Array(const QJSValue& array, int length);
     static void cb_MapOpened(QString mapName);
 
 private:
@@ -35,6 +40,9 @@ private:
     QStringList filepaths;
     QList<QJSValue> modules;
     QMap<QString, QString> registeredActions;
+    // The callback functions exported by each module, looked up once when the modules are loaded.
+    QMap<CallbackType, QList<QPair<QJSValue, QJSValue>>> callbacks;
+    bool invokingBlocksChanged = false;
 
     void loadModules(QStringList moduleFiles);
     void invokeCallback(CallbackType type, QJSValueList args);
@@ -31,6 +31,8 @@ public:
     void create(QString);
     virtual void paint(QGraphicsSceneMouseEvent*);
     virtual void draw();
+    // Redraws only the square at the given tile index.
+    void drawSquare(int index);
     int getIndexAt(int, int);
     int width();
     int height();
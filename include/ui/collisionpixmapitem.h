@@ -20,12 +20,16 @@ public:
     MovementPermissionsSelector* movementPermissionsSelector;
     qreal* opacity;
     void updateMovementPermissionSelection(QGraphicsSceneMouseEvent* event);
+    using MapPixmapItem::paint;
     virtual void paint(QGraphicsSceneMouseEvent*);
     virtual void floodFill(QGraphicsSceneMouseEvent*);
     virtual void magicFill(QGraphicsSceneMouseEvent*);
     virtual void pick(QGraphicsSceneMouseEvent*);
     void draw(bool ignoreCache = false);
 
+protected:
+    void paintBlocks(QPainter* painter, const QRect& blockRect) override;
+
 private:
     unsigned actionId_ = 0;
 
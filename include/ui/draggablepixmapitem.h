@@ -37,7 +37,7 @@ public:
     void move(int x, int y);
     void emitPositionChanged();
     void updatePixmap();
-    void bind(QComboBox* combo, QString key);
+    QList<QMetaObject::Connection> bind(QComboBox* combo, QString key);
     void bindToUserData(QComboBox* combo, QString key);
 
 signals:
@@ -0,0 +1,39 @@
+#ifndef ENCOUNTERTABLEDELEGATES_H
+#define ENCOUNTERTABLEDELEGATES_H
+
+#include <QStyledItemDelegate>
+
+class QAbstractItemModel;
+
+// Edits a species with a combo box listing the project's species.
+class SpeciesComboDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit SpeciesComboDelegate(QAbstractItemModel* speciesModel, QObject* parent = nullptr);
+
+    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    void setEditorData(QWidget* editor, const QModelIndex& index) const override;
+    void setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const override;
+
+private:
+    QAbstractItemModel* speciesModel;
+};
+
+// Edits a number in [min, max] with a spin box.
+class SpinBoxDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit SpinBoxDelegate(int min, int max, QObject* parent = nullptr);
+
+    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    void setEditorData(QWidget* editor, const QModelIndex& index) const override;
+    void setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const override;
+
+private:
+    int min;
+    int max;
+};
+
+#endif // ENCOUNTERTABLEDELEGATES_H
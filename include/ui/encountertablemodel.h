@@ -0,0 +1,49 @@
+#ifndef ENCOUNTERTABLEMODEL_H
+#define ENCOUNTERTABLEMODEL_H
+
+#include "wildmoninfo.h"
+
+#include <QAbstractTableModel>
+
+class Project;
+
+// One encounter field (land, water, ...) of a map's wild encounter group. Edits are made to the
+// model's WildMonInfo, which is read back with encounterData.
+class EncounterTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit EncounterTableModel(WildMonInfo monInfo, EncounterField monField, Project* project, QObject* parent = nullptr);
+
+    enum Column {
+        Slot,
+        Group,
+        Species,
+        MinLevel,
+        MaxLevel,
+        EncounterChance,
+        SlotRatio,
+        EncounterRate,
+        Count,
+    };
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
+    WildMonInfo encounterData() const;
+    bool hasGroups() const;
+
+private:
+    WildMonInfo monInfo;
+    EncounterField monField;
+    Project* project;
+    // Per slot, the group the slot belongs to and its chance of being chosen within it.
+    QVector<QString> groupNames;
+    QVector<double> slotPercentages;
+};
+
+#endif // ENCOUNTERTABLEMODEL_H
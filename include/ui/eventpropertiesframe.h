@@ -4,24 +4,40 @@
 #include "event.h"
 
 #include <QFrame>
+#include <QMap>
+#include <QList>
+#include <QToolButton>
 
 namespace Ui {
 class EventPropertiesFrame;
 }
 
+class CustomAttributesTable;
+
+// Frames are built once for an event type and then reused: setEvent points a frame at another
+// event of that type, and the connections made for the previous event are dropped by unbind.
 class EventPropertiesFrame : public QFrame {
     Q_OBJECT
 
 public:
-    explicit EventPropertiesFrame(Event* event, QWidget* parent = nullptr);
+    explicit EventPropertiesFrame(QString eventType, QWidget* parent = nullptr);
     ~EventPropertiesFrame();
     void paintEvent(QPaintEvent*);
 
+    void setEvent(Event* event);
+    void unbind();
+
 public:
     Ui::EventPropertiesFrame* ui;
+    QString eventType;
+    // The widget editing each of the event type's fields, keyed by field name.
+    QMap<QString, QWidget*> fields;
+    QToolButton* openScriptButton = nullptr;
+    QList<QMetaObject::Connection> connections;
 
 private:
-    Event* event;
+    Event* event = nullptr;
+    CustomAttributesTable* customAttributes = nullptr;
     bool firstShow = true;
 };
 
@@ -0,0 +1,23 @@
+#ifndef LOGVIEWER_H
+#define LOGVIEWER_H
+
+#include <QDialog>
+#include <QPlainTextEdit>
+#include <QTimer>
+
+// Shows the most recent log messages, updating as new ones are logged.
+class LogViewer : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit LogViewer(QWidget* parent = nullptr);
+
+private:
+    QPlainTextEdit* textEdit;
+    QTimer refreshTimer;
+    quint64 linesSeen = 0;
+
+    void appendNewLines();
+};
+
+#endif // LOGVIEWER_H
@@ -22,6 +22,9 @@ class MapImageExporter : public QDialog {
 public:
     explicit MapImageExporter(QWidget* parent, Editor* editor, ImageExporterMode mode);
     ~MapImageExporter();
+    Map* getMap() const {
+        return this->map;
+    }
 
 private:
     Ui::MapImageExporter* ui;
@@ -50,8 +53,12 @@ private:
 
     void updatePreview();
     void saveImage();
-    QPixmap getStitchedImage(QProgressDialog* progress, bool includeBorder);
+    QImage getStitchedImage(QProgressDialog* progress, bool includeBorder);
     QPixmap getFormattedMapPixmap(Map* map, bool ignoreBorder);
+    void paintEvents(QPainter* painter, Map* map);
+    bool showEventGroup(Event::Group group);
+    QRect drawTimelapseFrame(QImage* frame, bool fullRedraw);
+    QVector<QRgb> getTimelapseColorTable(const QImage& firstFrame);
     bool historyItemAppliesToFrame(const QUndoCommand* command);
 
 private slots:
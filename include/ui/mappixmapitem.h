@@ -5,13 +5,11 @@
 #include "settings.h"
 #include "metatileselector.h"
 #include <QGraphicsPixmapItem>
+#include <QHash>
 
 class MapPixmapItem : public QObject, public QGraphicsPixmapItem {
     Q_OBJECT
 
-private:
-    using QGraphicsPixmapItem::paint;
-
 public:
     enum class PaintMode { Disabled, Metatiles, EventObjects };
     MapPixmapItem(Map* map_, MetatileSelector* metatileSelector, Settings* settings) {
@@ -23,6 +21,7 @@ public:
         this->lockedAxis = MapPixmapItem::Axis::None;
         this->prevStraightPathState = false;
         setAcceptHoverEvents(true);
+        setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
     }
     MapPixmapItem::PaintMode paintingMode;
     Map* map;
@@ -57,15 +56,30 @@ public:
     virtual void shift(QGraphicsSceneMouseEvent*);
     void shift(int xDelta, int yDelta, bool fromScriptCall = false);
     virtual void draw(bool ignoreCache = false);
+    QRectF boundingRect() const override;
+    QPainterPath shape() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
     void updateMetatileSelection(QGraphicsSceneMouseEvent* event);
     void paintNormal(int x, int y, bool fromScriptCall = false);
     void lockNondominantAxis(QGraphicsSceneMouseEvent* event);
     QPoint adjustCoords(QPoint pos);
 
+protected:
+    // The map is displayed as square chunks of metatiles. Chunks are rendered when they are first
+    // painted and dropped once they are scrolled out of view, so large layouts only pay for what is visible.
+    static const int chunkSize = 32;
+    void updateChunks(const QRect& dirtyBlocks, bool ignoreCache);
+    virtual void paintBlocks(QPainter* painter, const QRect& blockRect);
+
 private:
     void paintSmartPath(int x, int y, bool fromScriptCall = false);
     static QList<int> smartPathTable;
 
+    QHash<int, QPixmap> chunks;
+    QSize chunksMapSize;
+    QPixmap getChunk(int chunkX, int chunkY);
+    void evictChunks(const QRect& keepRect);
+
     unsigned actionId_ = 0;
 
 signals:
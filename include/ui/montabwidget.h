@@ -7,6 +7,7 @@
 #include <QVector>
 
 class Editor;
+class EncounterTableModel;
 
 class MonTabWidget : public QTabWidget {
 
@@ -20,11 +21,11 @@ public:
     void populateTab(int tabIndex, WildMonInfo monInfo, QString fieldName);
     void clear();
 
-    void createSpeciesTableRow(QTableWidget* table, WildPokemon mon, int index, QString fieldName);
-
     void clearTableAt(int index);
 
-    QTableWidget* tableAt(int tabIndex);
+    QTableView* tableAt(int tabIndex);
+    // The encounters edited in an active tab.
+    WildMonInfo encounterDataAt(int tabIndex);
 
 public slots:
     void setTabActive(int index, bool active = true);
@@ -32,6 +33,7 @@ public slots:
 private:
     bool eventFilter(QObject* object, QEvent* event);
     void askActivateTab(int tabIndex, QPoint menuPos);
+    void setTableModel(QTableView* table, EncounterTableModel* model);
 
     QVector<bool> activeTabs;
 
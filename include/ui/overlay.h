@@ -2,9 +2,12 @@
 #define OVERLAY_H
 
 #include <QList>
+#include <QHash>
+#include <QCache>
 #include <QString>
 #include <QColor>
 #include <QPainter>
+#include <QPixmap>
 
 class OverlayItem {
 public:
@@ -12,6 +15,10 @@ public:
     }
     virtual ~OverlayItem(){};
     virtual void render(QPainter*){};
+    // The area the item draws to, in scene coordinates.
+    virtual QRect boundingRect() const {
+        return QRect();
+    }
 };
 
 class OverlayText : public OverlayItem {
@@ -26,6 +33,7 @@ public:
     ~OverlayText() {
     }
     virtual void render(QPainter* painter);
+    virtual QRect boundingRect() const;
 
 private:
     QString text;
@@ -48,6 +56,7 @@ public:
     ~OverlayRect() {
     }
     virtual void render(QPainter* painter);
+    virtual QRect boundingRect() const;
 
 private:
     int x;
@@ -68,6 +77,7 @@ public:
     ~OverlayImage() {
     }
     virtual void render(QPainter* painter);
+    virtual QRect boundingRect() const;
 
 private:
     int x;
@@ -77,19 +87,31 @@ private:
 
 class Overlay {
 public:
-    Overlay() {
+    Overlay() : cellPixmaps(32 * 1024) {
     }
     ~Overlay() {
         this->clearItems();
     }
     QList<OverlayItem*> getItems();
     void clearItems();
-    void addText(QString text, int x, int y, QString color = "#000000", int fontSize = 12);
-    void addRect(int x, int y, int width, int height, QString color = "#000000", bool filled = false);
-    void addImage(int x, int y, QString filepath);
+    // Each returns the area of the scene covered by the new item.
+    QRect addText(QString text, int x, int y, QString color = "#000000", int fontSize = 12);
+    QRect addRect(int x, int y, int width, int height, QString color = "#000000", bool filled = false);
+    QRect addImage(int x, int y, QString filepath);
+    void render(QPainter* painter, const QRectF& exposedRect);
 
 private:
     QList<OverlayItem*> items;
+    QList<QRect> itemBounds;
+
+    // Items are bucketed into square cells of the scene, so only cells in the exposed area are visited.
+    // Unless the view is zoomed in, each cell is drawn from a pixmap of its items rendered ahead of time.
+    static const int cellSize = 256;
+    QHash<quint64, QList<int>> cellItems;
+    QCache<quint64, QPixmap> cellPixmaps;
+    static quint64 cellKey(int column, int row);
+    QRect addItem(OverlayItem* item);
+    QRect cellRange(const QRect& rect) const;
 };
 
 #endif // OVERLAY_H
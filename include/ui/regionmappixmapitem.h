@@ -23,6 +23,8 @@ public:
     virtual void paint(QGraphicsSceneMouseEvent*);
     virtual void select(QGraphicsSceneMouseEvent*);
     virtual void draw();
+    // Redraws only the given map square.
+    void drawSquare(int index);
 
 signals:
     void mouseEvent(QGraphicsSceneMouseEvent*, RegionMapPixmapItem*);
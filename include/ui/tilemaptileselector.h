@@ -8,6 +8,7 @@ class TilemapTileSelector : public SelectablePixmapItem {
 public:
     TilemapTileSelector(QPixmap pixmap_) : SelectablePixmapItem(8, 8, 1, 1) {
         this->tilemap = pixmap_;
+        this->tileAtlas = pixmap_.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
         this->setPixmap(this->tilemap);
         this->numTilesWide = tilemap.width() / 8;
         this->selectedTile = 0x00;
@@ -24,6 +25,8 @@ public:
 
     QPixmap tilemap;
     QImage tileImg(unsigned tileId);
+    // Draws the tile straight from the tile atlas, without copying it.
+    void paintTile(QPainter* painter, const QPoint& pos, unsigned tileId);
 
 protected:
     void mousePressEvent(QGraphicsSceneMouseEvent*);
@@ -33,6 +36,8 @@ protected:
     void hoverLeaveEvent(QGraphicsSceneHoverEvent*);
 
 private:
+    // The tilemap image with its palette resolved, which tiles are drawn from.
+    QImage tileAtlas;
     int numTilesWide;
     size_t numTiles;
     void updateSelectedTile();
@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui qml
+QT       += core gui qml concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -18,6 +18,7 @@ SOURCES += src/core/block.cpp \
     src/core/blockdata.cpp \
     src/core/event.cpp \
     src/core/heallocation.cpp \
+    src/core/gifwriter.cpp \
     src/core/imageexport.cpp \
     src/core/map.cpp \
     src/core/maplayout.cpp \
@@ -38,6 +39,7 @@ SOURCES += src/core/block.cpp \
     src/ui/connectionpixmapitem.cpp \
     src/ui/currentselectedmetatilespixmapitem.cpp \
     src/ui/overlay.cpp \
+    src/ui/logviewer.cpp \
     src/ui/regionmaplayoutpixmapitem.cpp \
     src/ui/regionmapentriespixmapitem.cpp \
     src/ui/cursortilerect.cpp \
@@ -58,6 +60,8 @@ SOURCES += src/core/block.cpp \
     src/ui/noscrollcombobox.cpp \
     src/ui/noscrollspinbox.cpp \
     src/ui/montabwidget.cpp \
+    src/ui/encountertablemodel.cpp \
+    src/ui/encountertabledelegates.cpp \
     src/ui/paletteeditor.cpp \
     src/ui/selectablepixmapitem.cpp \
     src/ui/tileseteditor.cpp \
@@ -76,6 +80,7 @@ SOURCES += src/core/block.cpp \
     src/ui/preferenceeditor.cpp \
     src/config.cpp \
     src/editor.cpp \
+    src/headless.cpp \
     src/main.cpp \
     src/mainwindow.cpp \
     src/project.cpp \
@@ -88,6 +93,7 @@ HEADERS  += include/core/block.h \
     include/core/event.h \
     include/core/heallocation.h \
     include/core/history.h \
+    include/core/gifwriter.h \
     include/core/imageexport.h \
     include/core/map.h \
     include/core/mapconnection.h \
@@ -129,6 +135,8 @@ HEADERS  += include/core/block.h \
     include/ui/noscrollcombobox.h \
     include/ui/noscrollspinbox.h \
     include/ui/montabwidget.h \
+    include/ui/encountertablemodel.h \
+    include/ui/encountertabledelegates.h \
     include/ui/adjustingstackedwidget.h \
     include/ui/paletteeditor.h \
     include/ui/selectablepixmapitem.h \
@@ -141,6 +149,7 @@ HEADERS  += include/core/block.h \
     include/ui/mapimageexporter.h \
     include/ui/newtilesetdialog.h \
     include/ui/overlay.h \
+    include/ui/logviewer.h \
     include/ui/flowlayout.h \
     include/ui/mapruler.h \
     include/ui/shortcut.h \
@@ -149,6 +158,7 @@ HEADERS  += include/core/block.h \
     include/ui/preferenceeditor.h \
     include/config.h \
     include/editor.h \
+    include/headless.h \
     include/mainwindow.h \
     include/project.h \
     include/scripting.h \
@@ -170,6 +170,13 @@ void PorymapConfig::parseConfigKeyValue(QString key, QString value) {
         if (!ok) {
             logWarn(QString("Invalid config value for monitor_files: '%1'. Must be 0 or 1.").arg(value));
         }
+    } else if (key == "cache_budget_mb") {
+        bool ok;
+        this->cacheBudgetMB = qMax(64, value.toInt(&ok));
+        if (!ok) {
+            logWarn(QString("Invalid config value for cache_budget_mb: '%1'. Must be an integer.").arg(value));
+            this->cacheBudgetMB = 1024;
+        }
     } else if (key == "region_map_dimensions") {
         bool ok1, ok2;
         QStringList dims = value.split("x");
@@ -212,6 +219,7 @@ QMap<QString, QString> PorymapConfig::getKeyValueMap() {
     map.insert("show_player_view", this->showPlayerView ? "1" : "0");
     map.insert("show_cursor_tile", this->showCursorTile ? "1" : "0");
     map.insert("monitor_files", this->monitorFiles ? "1" : "0");
+    map.insert("cache_budget_mb", QString("%1").arg(this->cacheBudgetMB));
     map.insert("region_map_dimensions", QString("%1x%2").arg(this->regionMapDimensions.width()).arg(this->regionMapDimensions.height()));
     map.insert("theme", this->theme);
     map.insert("text_editor_open_directory", this->textEditorOpenFolder);
@@ -256,6 +264,11 @@ void PorymapConfig::setMonitorFiles(bool monitor) {
     this->save();
 }
 
+void PorymapConfig::setCacheBudgetMB(int megabytes) {
+    this->cacheBudgetMB = qMax(64, megabytes);
+    this->save();
+}
+
 void PorymapConfig::setMainGeometry(QByteArray mainWindowGeometry_, QByteArray mainWindowState_, QByteArray mapSplitterState_, QByteArray mainSplitterState_) {
     this->mainWindowGeometry = mainWindowGeometry_;
     this->mainWindowState = mainWindowState_;
@@ -390,6 +403,10 @@ bool PorymapConfig::getMonitorFiles() {
     return this->monitorFiles;
 }
 
+int PorymapConfig::getCacheBudgetMB() {
+    return this->cacheBudgetMB;
+}
+
 QSize PorymapConfig::getRegionMapDimensions() {
     return this->regionMapDimensions;
 }
@@ -611,6 +628,12 @@ BaseGameVersion ProjectConfig::getBaseGameVersion() {
     return this->baseGameVersion;
 }
 
+void ProjectConfig::loadDefaults(const QString& baseGameVersion) {
+    this->reset();
+    this->baseGameVersion = baseGameVersionReverseMap.value(baseGameVersion, BaseGameVersion::pokeemerald);
+    this->setUnreadKeys();
+}
+
 void ProjectConfig::setRecentMap(const QString& map) {
     this->recentMap = map;
     this->save();
@@ -1,5 +1,7 @@
 #include "blockdata.h"
 
+#include <algorithm>
+
 QByteArray Blockdata::serialize() const {
     QByteArray data;
     for (const auto& block : *this) {
@@ -9,3 +11,215 @@ QByteArray Blockdata::serialize() const {
     }
     return data;
 }
+
+BlockdataDiff::BlockdataDiff(const Blockdata& oldBlocks, const Blockdata& newBlocks) {
+    int length = qMin(oldBlocks.length(), newBlocks.length());
+    int numChanged = 0;
+    for (int i = 0; i < length; i++) {
+        if (oldBlocks.at(i) != newBlocks.at(i))
+            numChanged++;
+    }
+    if (!numChanged)
+        return;
+
+    // When most of the map changed (e.g. shifting it) runs of changes would cost about as much as
+    // the whole blockdata, so hold on to the two copies instead. These are implicitly shared with
+    // the caller, so nothing is copied here.
+    if (numChanged * 2 > length && oldBlocks.length() == newBlocks.length()) {
+        this->snapshot = true;
+        this->oldSnapshot = oldBlocks;
+        this->newSnapshot = newBlocks;
+        return;
+    }
+
+    for (int i = 0; i < length;) {
+        if (oldBlocks.at(i) == newBlocks.at(i)) {
+            i++;
+            continue;
+        }
+        int start = i;
+        while (i < length && oldBlocks.at(i) != newBlocks.at(i))
+            i++;
+        this->spans.append(BlockSpan{ start, oldBlocks.mid(start, i - start), newBlocks.mid(start, i - start) });
+    }
+}
+
+void BlockdataDiff::record(int index, Block oldBlock, Block newBlock) {
+    if (this->snapshot) {
+        if (index >= 0 && index < this->newSnapshot.length())
+            this->newSnapshot[index] = newBlock;
+        return;
+    }
+    this->changes.append(BlockChange{ index, oldBlock, newBlock });
+    this->compacted = false;
+}
+
+// Expands the spans and any changes recorded after them into individual changes, in order.
+QVector<BlockChange> BlockdataDiff::toChanges() const {
+    QVector<BlockChange> expanded;
+    for (const BlockSpan& span : this->spans) {
+        for (int i = 0; i < span.oldBlocks.length(); i++)
+            expanded.append(BlockChange{ span.start + i, span.oldBlocks.at(i), span.newBlocks.at(i) });
+    }
+    expanded += this->changes;
+    return expanded;
+}
+
+// Replaces the contents of the diff with spans built from changes sorted by index.
+void BlockdataDiff::setChanges(const QVector<BlockChange>& sortedChanges) {
+    this->changes.clear();
+    this->spans.clear();
+    for (int i = 0; i < sortedChanges.length();) {
+        BlockSpan span;
+        span.start = sortedChanges.at(i).index;
+        do {
+            span.oldBlocks.append(sortedChanges.at(i).oldBlock);
+            span.newBlocks.append(sortedChanges.at(i).newBlock);
+            i++;
+        } while (i < sortedChanges.length() && sortedChanges.at(i).index == span.start + span.oldBlocks.length());
+        this->spans.append(span);
+    }
+    this->spans.squeeze();
+}
+
+// Sorts the changes by index, collapses repeated changes to the same block
+// into one (keeping the first old value and the last new value), drops
+// changes that leave a block as it was, and joins the rest into spans.
+void BlockdataDiff::compact() {
+    if (this->compacted)
+        return;
+
+    QVector<BlockChange> all = this->toChanges();
+    std::stable_sort(all.begin(), all.end(), [](const BlockChange& a, const BlockChange& b) { return a.index < b.index; });
+
+    QVector<BlockChange> collapsed;
+    collapsed.reserve(all.length());
+    for (int i = 0; i < all.length();) {
+        BlockChange change = all.at(i);
+        int j = i + 1;
+        while (j < all.length() && all.at(j).index == change.index) {
+            change.newBlock = all.at(j).newBlock;
+            j++;
+        }
+        if (change.oldBlock != change.newBlock)
+            collapsed.append(change);
+        i = j;
+    }
+    this->setChanges(collapsed);
+    this->compacted = true;
+}
+
+// Combines this diff with one that was applied after it.
+void BlockdataDiff::merge(const BlockdataDiff& later) {
+    if (this->snapshot || later.snapshot) {
+        // Rebuild the blockdata from before this diff and after the later one, and diff those instead.
+        Blockdata oldBlocks = this->snapshot ? this->oldSnapshot : later.oldSnapshot;
+        if (!this->snapshot)
+            this->applyOld(&oldBlocks);
+        Blockdata newBlocks = later.snapshot ? later.newSnapshot : this->newSnapshot;
+        if (!later.snapshot)
+            later.applyNew(&newBlocks);
+        *this = BlockdataDiff(oldBlocks, newBlocks);
+        return;
+    }
+
+    this->compact();
+    BlockdataDiff other = later;
+    other.compact();
+
+    const QVector<BlockChange> first = this->toChanges();
+    const QVector<BlockChange> second = other.toChanges();
+    QVector<BlockChange> merged;
+    merged.reserve(first.length() + second.length());
+    int i = 0, j = 0;
+    while (i < first.length() || j < second.length()) {
+        if (j >= second.length() || (i < first.length() && first.at(i).index < second.at(j).index)) {
+            merged.append(first.at(i++));
+        } else if (i >= first.length() || second.at(j).index < first.at(i).index) {
+            merged.append(second.at(j++));
+        } else {
+            BlockChange change = first.at(i++);
+            change.newBlock = second.at(j++).newBlock;
+            if (change.oldBlock != change.newBlock)
+                merged.append(change);
+        }
+    }
+    this->setChanges(merged);
+}
+
+static void copySnapshot(Blockdata* blocks, const Blockdata& snapshot) {
+    if (blocks->length() == snapshot.length()) {
+        *blocks = snapshot;
+        return;
+    }
+    int length = qMin(blocks->length(), snapshot.length());
+    std::copy(snapshot.constBegin(), snapshot.constBegin() + length, blocks->begin());
+}
+
+static void copySpan(Blockdata* blocks, int start, const QVector<Block>& spanBlocks) {
+    int begin = qMax(start, 0);
+    int end = qMin(start + spanBlocks.length(), blocks->length());
+    if (begin < end)
+        std::copy(spanBlocks.constBegin() + (begin - start), spanBlocks.constBegin() + (end - start), blocks->begin() + begin);
+}
+
+void BlockdataDiff::applyNew(Blockdata* blocks) const {
+    if (this->snapshot) {
+        copySnapshot(blocks, this->newSnapshot);
+        return;
+    }
+    for (const auto& span : this->spans)
+        copySpan(blocks, span.start, span.newBlocks);
+    for (const auto& change : this->changes) {
+        if (change.index >= 0 && change.index < blocks->length())
+            (*blocks)[change.index] = change.newBlock;
+    }
+}
+
+void BlockdataDiff::applyOld(Blockdata* blocks) const {
+    if (this->snapshot) {
+        copySnapshot(blocks, this->oldSnapshot);
+        return;
+    }
+    // Apply in reverse so that an uncompacted diff still restores the original values.
+    for (int i = this->changes.length() - 1; i >= 0; i--) {
+        const BlockChange& change = this->changes.at(i);
+        if (change.index >= 0 && change.index < blocks->length())
+            (*blocks)[change.index] = change.oldBlock;
+    }
+    for (const auto& span : this->spans)
+        copySpan(blocks, span.start, span.oldBlocks);
+}
+
+// Snapshots are counted in full, though they may still share data with the layout.
+qint64 BlockdataDiff::memoryUsage() const {
+    qint64 bytes = sizeof(BlockdataDiff) + qint64(this->changes.capacity()) * sizeof(BlockChange);
+    bytes += qint64(this->oldSnapshot.capacity() + this->newSnapshot.capacity()) * sizeof(Block);
+    for (const auto& span : this->spans)
+        bytes += sizeof(BlockSpan) + qint64(span.oldBlocks.capacity() + span.newBlocks.capacity()) * sizeof(Block);
+    return bytes;
+}
+
+// Returns the area of a map with the given width that the diff touches.
+QRect BlockdataDiff::boundingRect(int width) const {
+    if (width <= 0)
+        return QRect();
+    if (this->snapshot)
+        return QRect(0, 0, width, (this->newSnapshot.length() + width - 1) / width);
+
+    QRect rect;
+    auto addRange = [&rect, width](int first, int last) {
+        int top = first / width;
+        int bottom = last / width;
+        if (top == bottom) {
+            rect |= QRect(QPoint(first % width, top), QPoint(last % width, bottom));
+        } else {
+            rect |= QRect(QPoint(0, top), QPoint(width - 1, bottom));
+        }
+    };
+    for (const auto& span : this->spans)
+        addRange(span.start, span.start + span.oldBlocks.length() - 1);
+    for (const auto& change : this->changes)
+        addRange(change.index, change.index);
+    return rect;
+}
@@ -9,17 +9,27 @@
 int getEventTypeMask(QList<Event*> events) {
     int eventTypeMask = 0;
     for (auto event : events) {
-        if (event->get("event_type") == EventType::Object) {
+        switch (event->kind()) {
+        case Event::Kind::Object:
             eventTypeMask |= IDMask_EventType_Object;
-        } else if (event->get("event_type") == EventType::Warp) {
+            break;
+        case Event::Kind::Warp:
             eventTypeMask |= IDMask_EventType_Warp;
-        } else if (event->get("event_type") == EventType::Trigger || event->get("event_type") == EventType::WeatherTrigger) {
+            break;
+        case Event::Kind::Trigger:
+        case Event::Kind::WeatherTrigger:
             eventTypeMask |= IDMask_EventType_Trigger;
-        } else if (event->get("event_type") == EventType::Sign || event->get("event_type") == EventType::HiddenItem
-            || event->get("event_type") == EventType::SecretBase) {
+            break;
+        case Event::Kind::Sign:
+        case Event::Kind::HiddenItem:
+        case Event::Kind::SecretBase:
             eventTypeMask |= IDMask_EventType_BG;
-        } else if (event->get("event_type") == EventType::HealLocation) {
+            break;
+        case Event::Kind::HealLocation:
             eventTypeMask |= IDMask_EventType_Heal;
+            break;
+        case Event::Kind::Unknown:
+            break;
         }
     }
     return eventTypeMask;
@@ -30,13 +40,24 @@ void renderMapBlocks(Map* map, bool ignoreCache = false) {
     map->collisionItem->draw(ignoreCache);
 }
 
-PaintMetatile::PaintMetatile(Map* map, const Blockdata& oldMetatiles, const Blockdata& newMetatiles, unsigned actionId, QUndoCommand* parent)
-    : QUndoCommand(parent) {
+// Applies an edit to the blocks last committed by the scripting API, rather than copying the whole map.
+void commitMapBlocks(Map* map, const BlockdataDiff& changes, bool undo) {
+    Blockdata* committed = &map->layout->lastCommitMapBlocks.blocks;
+    if (committed->length() != map->layout->blockdata.length()) {
+        *committed = map->layout->blockdata;
+    } else if (undo) {
+        changes.applyOld(committed);
+    } else {
+        changes.applyNew(committed);
+    }
+}
+
+PaintMetatile::PaintMetatile(Map* map, const BlockdataDiff& changes, unsigned actionId, QUndoCommand* parent) : QUndoCommand(parent) {
     setText("Paint Metatiles");
 
     this->map = map;
-    this->oldMetatiles = oldMetatiles;
-    this->newMetatiles = newMetatiles;
+    this->changes = changes;
+    this->changes.compact();
 
     this->actionId = actionId;
 }
@@ -47,9 +68,10 @@ void PaintMetatile::redo() {
     if (!map)
         return;
 
-    map->layout->blockdata = newMetatiles;
+    changes.applyNew(&map->layout->blockdata);
+    map->markBlocksDirty(changes);
 
-    map->layout->lastCommitMapBlocks.blocks = map->layout->blockdata;
+    commitMapBlocks(map, changes, false);
 
     renderMapBlocks(map);
 }
@@ -58,9 +80,10 @@ void PaintMetatile::undo() {
     if (!map)
         return;
 
-    map->layout->blockdata = oldMetatiles;
+    changes.applyOld(&map->layout->blockdata);
+    map->markBlocksDirty(changes);
 
-    map->layout->lastCommitMapBlocks.blocks = map->layout->blockdata;
+    commitMapBlocks(map, changes, true);
 
     renderMapBlocks(map);
 
@@ -76,7 +99,7 @@ bool PaintMetatile::mergeWith(const QUndoCommand* command) {
     if (actionId != other->actionId)
         return false;
 
-    newMetatiles = other->newMetatiles;
+    changes.merge(other->changes);
 
     return true;
 }
@@ -102,6 +125,7 @@ void PaintBorder::redo() {
         return;
 
     map->layout->border = newBorder;
+    map->layout->markBlocksChanged();
 
     map->borderItem->draw();
 }
@@ -111,6 +135,7 @@ void PaintBorder::undo() {
         return;
 
     map->layout->border = oldBorder;
+    map->layout->markBlocksChanged();
 
     map->borderItem->draw();
 
@@ -121,13 +146,12 @@ void PaintBorder::undo() {
     ************************************************************************
  ******************************************************************************/
 
-ShiftMetatiles::ShiftMetatiles(Map* map, const Blockdata& oldMetatiles, const Blockdata& newMetatiles, unsigned actionId, QUndoCommand* parent)
-    : QUndoCommand(parent) {
+ShiftMetatiles::ShiftMetatiles(Map* map, const BlockdataDiff& changes, unsigned actionId, QUndoCommand* parent) : QUndoCommand(parent) {
     setText("Shift Metatiles");
 
     this->map = map;
-    this->oldMetatiles = oldMetatiles;
-    this->newMetatiles = newMetatiles;
+    this->changes = changes;
+    this->changes.compact();
 
     this->actionId = actionId;
 }
@@ -138,9 +162,10 @@ void ShiftMetatiles::redo() {
     if (!map)
         return;
 
-    map->layout->blockdata = newMetatiles;
+    changes.applyNew(&map->layout->blockdata);
+    map->markBlocksDirty(changes);
 
-    map->layout->lastCommitMapBlocks.blocks = map->layout->blockdata;
+    commitMapBlocks(map, changes, false);
 
     renderMapBlocks(map, true);
 }
@@ -149,9 +174,10 @@ void ShiftMetatiles::undo() {
     if (!map)
         return;
 
-    map->layout->blockdata = oldMetatiles;
+    changes.applyOld(&map->layout->blockdata);
+    map->markBlocksDirty(changes);
 
-    map->layout->lastCommitMapBlocks.blocks = map->layout->blockdata;
+    commitMapBlocks(map, changes, true);
 
     renderMapBlocks(map, true);
 
@@ -167,7 +193,7 @@ bool ShiftMetatiles::mergeWith(const QUndoCommand* command) {
     if (actionId != other->actionId)
         return false;
 
-    this->newMetatiles = other->newMetatiles;
+    this->changes.merge(other->changes);
 
     return true;
 }
@@ -209,6 +235,7 @@ void ResizeMap::redo() {
         return;
 
     map->layout->blockdata = newMetatiles;
+    map->markAllBlocksDirty();
     map->setDimensions(newMapWidth, newMapHeight, false);
 
     map->layout->border = newBorder;
@@ -224,6 +251,7 @@ void ResizeMap::undo() {
         return;
 
     map->layout->blockdata = oldMetatiles;
+    map->markAllBlocksDirty();
     map->setDimensions(oldMapWidth, oldMapHeight, false);
 
     map->layout->border = oldBorder;
@@ -463,6 +491,7 @@ ScriptEditMap::ScriptEditMap(
     setText("Script Edit Map");
 
     this->map = map;
+    this->resized = true;
 
     this->newMetatiles = newMetatiles;
     this->oldMetatiles = oldMetatiles;
@@ -473,13 +502,35 @@ ScriptEditMap::ScriptEditMap(
     this->newMapHeight = newMapDimensions.height();
 }
 
+ScriptEditMap::ScriptEditMap(Map* map, const BlockdataDiff& changes, QUndoCommand* parent) : QUndoCommand(parent) {
+    setText("Script Edit Map");
+
+    this->map = map;
+    this->resized = false;
+
+    this->changes = changes;
+    this->changes.compact();
+
+    this->oldMapWidth = this->newMapWidth = map->getWidth();
+    this->oldMapHeight = this->newMapHeight = map->getHeight();
+}
+
 void ScriptEditMap::redo() {
     QUndoCommand::redo();
 
     if (!map)
         return;
 
+    if (!resized) {
+        changes.applyNew(&map->layout->blockdata);
+        map->markBlocksDirty(changes);
+        commitMapBlocks(map, changes, false);
+        renderMapBlocks(map);
+        return;
+    }
+
     map->layout->blockdata = newMetatiles;
+    map->markAllBlocksDirty();
     if (newMapWidth != map->getWidth() || newMapHeight != map->getHeight()) {
         map->setDimensions(newMapWidth, newMapHeight, false);
     }
@@ -494,7 +545,17 @@ void ScriptEditMap::undo() {
     if (!map)
         return;
 
+    if (!resized) {
+        changes.applyOld(&map->layout->blockdata);
+        map->markBlocksDirty(changes);
+        commitMapBlocks(map, changes, true);
+        renderMapBlocks(map);
+        QUndoCommand::undo();
+        return;
+    }
+
     map->layout->blockdata = oldMetatiles;
+    map->markAllBlocksDirty();
     if (oldMapWidth != map->getWidth() || oldMapHeight != map->getHeight()) {
         map->setDimensions(oldMapWidth, oldMapHeight, false);
     }
@@ -12,6 +12,38 @@ QString EventType::HiddenItem = "event_hidden_item";
 QString EventType::SecretBase = "event_secret_base";
 QString EventType::HealLocation = "event_heal_location";
 
+QString EventGroup::Object = "object_event_group";
+QString EventGroup::Warp = "warp_event_group";
+QString EventGroup::Coord = "coord_event_group";
+QString EventGroup::Bg = "bg_event_group";
+QString EventGroup::Heal = "heal_event_group";
+
+// The keys that are stored in typed members instead of 'values'.
+enum class TypedKey { None, X, Y, Elevation, EventType, EventGroupType };
+
+static TypedKey typedKey(const QString& key) {
+    if (key == QLatin1String("x"))
+        return TypedKey::X;
+    if (key == QLatin1String("y"))
+        return TypedKey::Y;
+    if (key == QLatin1String("elevation"))
+        return TypedKey::Elevation;
+    if (key == QLatin1String("event_type"))
+        return TypedKey::EventType;
+    if (key == QLatin1String("event_group_type"))
+        return TypedKey::EventGroupType;
+    return TypedKey::None;
+}
+
+// These match QString::toShort/toUShort, which give 0 for out-of-range values.
+static int16_t toS16(int value) {
+    return (value >= -0x8000 && value <= 0x7FFF) ? static_cast<int16_t>(value) : 0;
+}
+
+static uint16_t toU16(int value) {
+    return (value >= 0 && value <= 0xFFFF) ? static_cast<uint16_t>(value) : 0;
+}
+
 Event::Event() : spriteWidth(16), spriteHeight(16), usingSprite(false) {
 }
 
@@ -23,7 +55,14 @@ Event::Event(const Event& toCopy)
       spriteHeight(toCopy.spriteHeight),
       frame(toCopy.frame),
       hFlip(toCopy.hFlip),
-      usingSprite(toCopy.usingSprite) {
+      usingSprite(toCopy.usingSprite),
+      posX(toCopy.posX),
+      posY(toCopy.posY),
+      posElevation(toCopy.posElevation),
+      eventType(toCopy.eventType),
+      eventGroupType(toCopy.eventGroupType),
+      eventKind(toCopy.eventKind),
+      eventGroup(toCopy.eventGroup) {
 }
 
 Event::Event(QJsonObject obj, QString type) : Event() {
@@ -31,6 +70,139 @@ Event::Event(QJsonObject obj, QString type) : Event() {
     this->readCustomValues(obj);
 }
 
+QString Event::get(const QString& key) const {
+    switch (typedKey(key)) {
+    case TypedKey::X:
+        return QString::number(posX);
+    case TypedKey::Y:
+        return QString::number(posY);
+    case TypedKey::Elevation:
+        return QString::number(posElevation);
+    case TypedKey::EventType:
+        return eventType;
+    case TypedKey::EventGroupType:
+        return eventGroupType;
+    case TypedKey::None:
+        break;
+    }
+    return values.value(key);
+}
+
+int Event::getInt(const QString& key) const {
+    switch (typedKey(key)) {
+    case TypedKey::X:
+        return posX;
+    case TypedKey::Y:
+        return posY;
+    case TypedKey::Elevation:
+        return posElevation;
+    default:
+        return get(key).toInt(nullptr, 0);
+    }
+}
+
+uint16_t Event::getU16(const QString& key) const {
+    switch (typedKey(key)) {
+    case TypedKey::X:
+        return toU16(posX);
+    case TypedKey::Y:
+        return toU16(posY);
+    case TypedKey::Elevation:
+        return toU16(posElevation);
+    default:
+        return get(key).toUShort(nullptr, 0);
+    }
+}
+
+int16_t Event::getS16(const QString& key) const {
+    switch (typedKey(key)) {
+    case TypedKey::X:
+        return toS16(posX);
+    case TypedKey::Y:
+        return toS16(posY);
+    case TypedKey::Elevation:
+        return toS16(posElevation);
+    default:
+        return get(key).toShort(nullptr, 0);
+    }
+}
+
+void Event::put(const QString& key, int value) {
+    switch (typedKey(key)) {
+    case TypedKey::X:
+        posX = value;
+        break;
+    case TypedKey::Y:
+        posY = value;
+        break;
+    case TypedKey::Elevation:
+        posElevation = value;
+        break;
+    default:
+        put(key, QString::number(value));
+        break;
+    }
+}
+
+void Event::put(const QString& key, const QString& value) {
+    switch (typedKey(key)) {
+    case TypedKey::X:
+        posX = value.toInt(nullptr, 0);
+        break;
+    case TypedKey::Y:
+        posY = value.toInt(nullptr, 0);
+        break;
+    case TypedKey::Elevation:
+        posElevation = value.toInt(nullptr, 0);
+        break;
+    case TypedKey::EventType: {
+        // Known types share the EventType strings.
+        static const QList<QPair<QString*, Kind>> kinds = {
+            { &EventType::Object, Kind::Object },
+            { &EventType::Warp, Kind::Warp },
+            { &EventType::Trigger, Kind::Trigger },
+            { &EventType::WeatherTrigger, Kind::WeatherTrigger },
+            { &EventType::Sign, Kind::Sign },
+            { &EventType::HiddenItem, Kind::HiddenItem },
+            { &EventType::SecretBase, Kind::SecretBase },
+            { &EventType::HealLocation, Kind::HealLocation },
+        };
+        eventType = value;
+        eventKind = Kind::Unknown;
+        for (const auto& kind : kinds) {
+            if (value == *kind.first) {
+                eventType = *kind.first;
+                eventKind = kind.second;
+                break;
+            }
+        }
+        break;
+    }
+    case TypedKey::EventGroupType: {
+        static const QList<QPair<QString*, Group>> groups = {
+            { &EventGroup::Object, Group::Object },
+            { &EventGroup::Warp, Group::Warp },
+            { &EventGroup::Coord, Group::Coord },
+            { &EventGroup::Bg, Group::Bg },
+            { &EventGroup::Heal, Group::Heal },
+        };
+        eventGroupType = value;
+        eventGroup = Group::Unknown;
+        for (const auto& group : groups) {
+            if (value == *group.first) {
+                eventGroupType = *group.first;
+                eventGroup = group.second;
+                break;
+            }
+        }
+        break;
+    }
+    case TypedKey::None:
+        values.insert(key, value);
+        break;
+    }
+}
+
 Event* Event::createNewEvent(QString event_type, QString map_name, Project* project) {
     Event* event = nullptr;
     if (event_type == EventType::Object) {
@@ -354,7 +526,11 @@ void Event::setPixmapFromSpritesheet(QImage spritesheet, int spriteWidth, int sp
         img = img.transformed(QTransform().scale(-1, 1));
     }
     img.setColor(0, qRgba(0, 0, 0, 0));
-    pixmap = QPixmap::fromImage(img);
+    setSpritePixmap(QPixmap::fromImage(img), spriteWidth, spriteHeight);
+}
+
+void Event::setSpritePixmap(const QPixmap& sprite, int spriteWidth, int spriteHeight) {
+    pixmap = sprite;
     this->spriteWidth = spriteWidth;
     this->spriteHeight = spriteHeight;
     this->usingSprite = true;
@@ -0,0 +1,146 @@
+#include "gifwriter.h"
+#include "gif_lib.h"
+
+#include <climits>
+
+static int writeToFile(GifFileType* gif, const GifByteType* data, int size) {
+    return static_cast<int>(static_cast<QFile*>(gif->UserData)->write(reinterpret_cast<const char*>(data), size));
+}
+
+GifWriter::~GifWriter() {
+    close();
+}
+
+bool GifWriter::open(const QString& filepath, const QSize& size, const QVector<QRgb>& colorTable, int loopCount) {
+    close();
+    this->error.clear();
+    this->colorIndexes.clear();
+
+    // GIF color tables hold a power of two number of colors, up to 256.
+    this->colorTable = colorTable.mid(0, 256);
+    if (this->colorTable.isEmpty())
+        this->colorTable.append(qRgb(0, 0, 0));
+    int tableSize = 2;
+    while (tableSize < this->colorTable.length())
+        tableSize *= 2;
+    QVector<GifColorType> colors(tableSize);
+    for (int i = 0; i < this->colorTable.length(); i++) {
+        QRgb color = this->colorTable.at(i);
+        colors[i] = GifColorType{ static_cast<GifByteType>(qRed(color)), static_cast<GifByteType>(qGreen(color)), static_cast<GifByteType>(qBlue(color)) };
+        this->colorIndexes.insert(color | 0xFF000000, static_cast<uchar>(i));
+    }
+
+    this->file.setFileName(filepath);
+    if (!this->file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return fail(QString("Could not open '%1' for writing: %2").arg(filepath).arg(this->file.errorString()));
+    }
+
+    int gifError;
+    this->gif = EGifOpen(&this->file, writeToFile, &gifError);
+    if (!this->gif) {
+        return fail(QString("Failed to start GIF '%1': %2").arg(filepath).arg(GifErrorString(gifError)));
+    }
+    EGifSetGifVersion(this->gif, true);
+
+    ColorMapObject* colorMap = GifMakeMapObject(tableSize, colors.constData());
+    int result = EGifPutScreenDesc(this->gif, size.width(), size.height(), 8, 0, colorMap);
+    GifFreeMapObject(colorMap);
+    if (result == GIF_ERROR) {
+        return fail(QString("Failed to write GIF header: %1").arg(GifErrorString(this->gif->Error)));
+    }
+
+    // Netscape application extension, for looping the animation.
+    GifByteType loop[3] = { 0x01, static_cast<GifByteType>(loopCount & 0xFF), static_cast<GifByteType>((loopCount >> 8) & 0xFF) };
+    if (EGifPutExtensionLeader(this->gif, APPLICATION_EXT_FUNC_CODE) == GIF_ERROR || EGifPutExtensionBlock(this->gif, 11, "NETSCAPE2.0") == GIF_ERROR
+        || EGifPutExtensionBlock(this->gif, 3, loop) == GIF_ERROR || EGifPutExtensionTrailer(this->gif) == GIF_ERROR) {
+        return fail(QString("Failed to write GIF header: %1").arg(GifErrorString(this->gif->Error)));
+    }
+    return true;
+}
+
+bool GifWriter::writeFrame(const QImage& image, const QRect& rect, int delayMs) {
+    if (!this->gif)
+        return false;
+
+    QRect frameRect = rect & image.rect();
+    if (frameRect.isEmpty())
+        frameRect = QRect(0, 0, 1, 1);
+
+    // Later frames are drawn over the previous ones, so unchanged pixels outside the frame are kept.
+    GraphicsControlBlock gcb;
+    gcb.DisposalMode = DISPOSE_DO_NOT;
+    gcb.UserInputFlag = false;
+    gcb.DelayTime = delayMs / 10;
+    gcb.TransparentColor = NO_TRANSPARENT_COLOR;
+    GifByteType extension[4];
+    size_t extensionLength = EGifGCBToExtension(&gcb, extension);
+    if (EGifPutExtension(this->gif, GRAPHICS_EXT_FUNC_CODE, static_cast<int>(extensionLength), extension) == GIF_ERROR) {
+        return fail(QString("Failed to write GIF frame: %1").arg(GifErrorString(this->gif->Error)));
+    }
+
+    if (EGifPutImageDesc(this->gif, frameRect.x(), frameRect.y(), frameRect.width(), frameRect.height(), false, nullptr) == GIF_ERROR) {
+        return fail(QString("Failed to write GIF frame: %1").arg(GifErrorString(this->gif->Error)));
+    }
+
+    QImage source = image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32 ? image : image.convertToFormat(QImage::Format_RGB32);
+    QVector<GifPixelType> line(frameRect.width());
+    for (int y = frameRect.top(); y <= frameRect.bottom(); y++) {
+        const QRgb* pixels = reinterpret_cast<const QRgb*>(source.constScanLine(y));
+        for (int x = 0; x < frameRect.width(); x++) {
+            line[x] = getColorIndex(pixels[frameRect.x() + x]);
+        }
+        if (EGifPutLine(this->gif, line.data(), frameRect.width()) == GIF_ERROR) {
+            return fail(QString("Failed to write GIF frame: %1").arg(GifErrorString(this->gif->Error)));
+        }
+    }
+    return true;
+}
+
+bool GifWriter::close() {
+    bool success = true;
+    if (this->gif) {
+        success = EGifCloseFile(this->gif) != GIF_ERROR;
+        this->gif = nullptr;
+    }
+    if (this->file.isOpen()) {
+        this->file.close();
+        success = success && this->file.error() == QFileDevice::NoError;
+    }
+    return success && this->error.isEmpty();
+}
+
+// Colors that aren't in the color table use the nearest color in it. These are remembered, so each
+// distinct color is only searched for once.
+uchar GifWriter::getColorIndex(QRgb color) {
+    color |= 0xFF000000;
+    auto it = this->colorIndexes.constFind(color);
+    if (it != this->colorIndexes.constEnd())
+        return it.value();
+
+    int nearest = 0;
+    int nearestDistance = INT_MAX;
+    for (int i = 0; i < this->colorTable.length(); i++) {
+        QRgb candidate = this->colorTable.at(i);
+        int dr = qRed(color) - qRed(candidate);
+        int dg = qGreen(color) - qGreen(candidate);
+        int db = qBlue(color) - qBlue(candidate);
+        int distance = dr * dr + dg * dg + db * db;
+        if (distance < nearestDistance) {
+            nearest = i;
+            nearestDistance = distance;
+        }
+    }
+    this->colorIndexes.insert(color, static_cast<uchar>(nearest));
+    return static_cast<uchar>(nearest);
+}
+
+bool GifWriter::fail(const QString& message) {
+    if (this->error.isEmpty())
+        this->error = message;
+    if (this->gif) {
+        EGifCloseFile(this->gif);
+        this->gif = nullptr;
+    }
+    this->file.close();
+    return false;
+}
@@ -6,6 +6,8 @@
 #include "editcommands.h"
 
 #include <QTime>
+#include <QCryptographicHash>
+#include <QBitArray>
 #include <QPainter>
 #include <QImage>
 #include <QRegularExpression>
@@ -57,29 +59,20 @@ QString Map::bgEventsLabelFromName(QString mapName) {
     return QString("%1_MapBGEvents").arg(mapName);
 }
 
-int Map::getWidth() {
-    return layout->width.toInt(nullptr, 0);
+int Map::getWidth() const {
+    return layout->width;
 }
 
-int Map::getHeight() {
-    return layout->height.toInt(nullptr, 0);
+int Map::getHeight() const {
+    return layout->height;
 }
 
-int Map::getBorderWidth() {
-    return layout->border_width.toInt(nullptr, 0);
+int Map::getBorderWidth() const {
+    return layout->border_width;
 }
 
-int Map::getBorderHeight() {
-    return layout->border_height.toInt(nullptr, 0);
-}
-
-bool Map::mapBlockChanged(int i, const Blockdata& cache) {
-    if (cache.length() <= i)
-        return true;
-    if (layout->blockdata.length() <= i)
-        return true;
-
-    return layout->blockdata.at(i) != cache.at(i);
+int Map::getBorderHeight() const {
+    return layout->border_height;
 }
 
 bool Map::borderBlockChanged(int i, const Blockdata& cache) {
@@ -97,90 +90,107 @@ void Map::cacheBorder() {
         layout->cached_border.append(block);
 }
 
-void Map::cacheBlockdata() {
-    layout->cached_blockdata.clear();
-    for (const auto& block : layout->blockdata)
-        layout->cached_blockdata.append(block);
+void Map::markBlocksDirty(const QRect& rect) {
+    dirtyMetatileRect |= rect;
+    dirtyCollisionRect |= rect;
+    changedBlocksRect |= rect;
+    layout->markBlocksChanged();
+}
+
+void Map::markBlocksDirty(const BlockdataDiff& changes) {
+    QRect rect = changes.boundingRect(getWidth());
+    if (!rect.isNull()) {
+        markBlocksDirty(rect);
+    }
+}
+
+void Map::markAllBlocksDirty() {
+    markBlocksDirty(QRect(0, 0, getWidth(), getHeight()));
+}
+
+QRect Map::takeDirtyMetatileRect() {
+    QRect dirty = dirtyMetatileRect & QRect(0, 0, getWidth(), getHeight());
+    dirtyMetatileRect = QRect();
+    return dirty;
+}
+
+QRect Map::takeDirtyCollisionRect() {
+    QRect dirty = dirtyCollisionRect & QRect(0, 0, getWidth(), getHeight());
+    dirtyCollisionRect = QRect();
+    return dirty;
 }
 
-void Map::cacheCollision() {
-    layout->cached_collision.clear();
-    for (const auto& block : layout->blockdata)
-        layout->cached_collision.append(block);
+QRect Map::takeChangedBlocksRect() {
+    QRect changed = changedBlocksRect & QRect(0, 0, getWidth(), getHeight());
+    changedBlocksRect = QRect();
+    return changed;
+}
+
+void Map::paintBlocks(QPainter* painter, const QRect& blockRect, MapLayout* fromLayout) {
+    Tileset* primaryTileset = fromLayout ? fromLayout->tileset_primary : layout->tileset_primary;
+    Tileset* secondaryTileset = fromLayout ? fromLayout->tileset_secondary : layout->tileset_secondary;
+    int width_ = getWidth();
+    int numBlocks = layout->blockdata.length();
+    for (int y = blockRect.top(); y <= blockRect.bottom(); y++) {
+        for (int x = blockRect.left(); x <= blockRect.right(); x++) {
+            int i = y * width_ + x;
+            if (i >= numBlocks)
+                return;
+            Block block = layout->blockdata.at(i);
+            QImage metatile_image = getMetatileImage(block.tile, primaryTileset, secondaryTileset, metatileLayerOrder, metatileLayerOpacity);
+            painter->drawImage(QPoint(x * 16, y * 16), metatile_image);
+        }
+    }
 }
 
-QPixmap Map::renderCollision(qreal opacity, bool ignoreCache) {
-    bool changed_any = false;
+void Map::paintCollisionBlocks(QPainter* painter, const QRect& blockRect, qreal opacity) {
+    int width_ = getWidth();
+    int numBlocks = layout->blockdata.length();
+    for (int y = blockRect.top(); y <= blockRect.bottom(); y++) {
+        for (int x = blockRect.left(); x <= blockRect.right(); x++) {
+            int i = y * width_ + x;
+            if (i >= numBlocks)
+                return;
+            Block block = layout->blockdata.at(i);
+            QImage metatile_image = getMetatileImage(block.tile, layout->tileset_primary, layout->tileset_secondary, metatileLayerOrder, metatileLayerOpacity);
+            QImage collision_metatile_image = getCollisionMetatileImage(block);
+            QPoint metatile_origin = QPoint(x * 16, y * 16);
+            painter->setOpacity(1);
+            painter->drawImage(metatile_origin, metatile_image);
+            painter->setOpacity(opacity);
+            painter->drawImage(metatile_origin, collision_metatile_image);
+        }
+    }
+    painter->setOpacity(1);
+}
+
+QPixmap Map::renderCollision(qreal opacity) {
     int width_ = getWidth();
     int height_ = getHeight();
     if (collision_image.isNull() || collision_image.width() != width_ * 16 || collision_image.height() != height_ * 16) {
         collision_image = QImage(width_ * 16, height_ * 16, QImage::Format_RGBA8888);
-        changed_any = true;
-    }
-    if (layout->blockdata.isEmpty() || !width_ || !height_) {
-        collision_pixmap = collision_pixmap.fromImage(collision_image);
-        return collision_pixmap;
-    }
-    QPainter painter(&collision_image);
-    for (int i = 0; i < layout->blockdata.length(); i++) {
-        if (!ignoreCache && !mapBlockChanged(i, layout->cached_collision)) {
-            continue;
-        }
-        changed_any = true;
-        Block block = layout->blockdata.at(i);
-        QImage metatile_image = getMetatileImage(block.tile, layout->tileset_primary, layout->tileset_secondary, metatileLayerOrder, metatileLayerOpacity);
-        QImage collision_metatile_image = getCollisionMetatileImage(block);
-        int map_y = width_ ? i / width_ : 0;
-        int map_x = width_ ? i % width_ : 0;
-        QPoint metatile_origin = QPoint(map_x * 16, map_y * 16);
-        painter.setOpacity(1);
-        painter.drawImage(metatile_origin, metatile_image);
-        painter.save();
-        painter.setOpacity(opacity);
-        painter.drawImage(metatile_origin, collision_metatile_image);
-        painter.restore();
     }
-    painter.end();
-    cacheCollision();
-    if (changed_any) {
-        collision_pixmap = collision_pixmap.fromImage(collision_image);
+    if (!layout->blockdata.isEmpty() && width_ && height_) {
+        QPainter painter(&collision_image);
+        paintCollisionBlocks(&painter, QRect(0, 0, width_, height_), opacity);
+        painter.end();
     }
+    collision_pixmap = collision_pixmap.fromImage(collision_image);
     return collision_pixmap;
 }
 
-QPixmap Map::render(bool ignoreCache = false, MapLayout* fromLayout) {
-    bool changed_any = false;
+QPixmap Map::render(MapLayout* fromLayout) {
     int width_ = getWidth();
     int height_ = getHeight();
     if (image.isNull() || image.width() != width_ * 16 || image.height() != height_ * 16) {
         image = QImage(width_ * 16, height_ * 16, QImage::Format_RGBA8888);
-        changed_any = true;
     }
-    if (layout->blockdata.isEmpty() || !width_ || !height_) {
-        pixmap = pixmap.fromImage(image);
-        return pixmap;
+    if (!layout->blockdata.isEmpty() && width_ && height_) {
+        QPainter painter(&image);
+        paintBlocks(&painter, QRect(0, 0, width_, height_), fromLayout);
+        painter.end();
     }
-
-    QPainter painter(&image);
-    for (int i = 0; i < layout->blockdata.length(); i++) {
-        if (!ignoreCache && !mapBlockChanged(i, layout->cached_blockdata)) {
-            continue;
-        }
-        changed_any = true;
-        Block block = layout->blockdata.at(i);
-        QImage metatile_image = getMetatileImage(block.tile, fromLayout ? fromLayout->tileset_primary : layout->tileset_primary,
-            fromLayout ? fromLayout->tileset_secondary : layout->tileset_secondary, metatileLayerOrder, metatileLayerOpacity);
-        int map_y = width_ ? i / width_ : 0;
-        int map_x = width_ ? i % width_ : 0;
-        QPoint metatile_origin = QPoint(map_x * 16, map_y * 16);
-        painter.drawImage(metatile_origin, metatile_image);
-    }
-    painter.end();
-    if (changed_any) {
-        cacheBlockdata();
-        pixmap = pixmap.fromImage(image);
-    }
-
+    pixmap = pixmap.fromImage(image);
     return pixmap;
 }
 
@@ -223,7 +233,6 @@ QPixmap Map::renderBorder(bool ignoreCache) {
 }
 
 QPixmap Map::renderConnection(MapConnection connection, MapLayout* fromLayout) {
-    render(true, fromLayout);
     int x, y, w, h;
     if (connection.direction == "up") {
         x = 0;
@@ -252,9 +261,34 @@ QPixmap Map::renderConnection(MapConnection connection, MapLayout* fromLayout) {
         w = getWidth();
         h = getHeight();
     }
-    QImage connection_image = image.copy(x * 16, y * 16, w * 16, h * 16);
+    QRect blockRect = QRect(x, y, w, h) & QRect(0, 0, getWidth(), getHeight());
+
+    // Only the blocks inside the strip are drawn, and the result is reused until this map's
+    // layout or its blocks (which may be edited through another map sharing the layout) or the tilesets it's drawn with change.
+    Tileset* primaryTileset = fromLayout ? fromLayout->tileset_primary : layout->tileset_primary;
+    Tileset* secondaryTileset = fromLayout ? fromLayout->tileset_secondary : layout->tileset_secondary;
+    quint64 primaryRevision = primaryTileset ? primaryTileset->revision() : 0;
+    quint64 secondaryRevision = secondaryTileset ? secondaryTileset->revision() : 0;
+    auto it = connectionStrips.constFind(connection.direction);
+    if (it != connectionStrips.constEnd() && it->blockRect == blockRect && it->layout == layout && it->blocksRevision == layout->blocksRevision()
+        && it->primaryTileset == primaryTileset && it->secondaryTileset == secondaryTileset && it->primaryRevision == primaryRevision
+        && it->secondaryRevision == secondaryRevision && it->layerOrder == metatileLayerOrder && it->layerOpacity == metatileLayerOpacity) {
+        return it->pixmap;
+    }
+
+    QImage connection_image(qMax(blockRect.width(), 0) * 16, qMax(blockRect.height(), 0) * 16, QImage::Format_RGBA8888);
+    if (!connection_image.isNull()) {
+        connection_image.fill(Qt::transparent);
+        QPainter painter(&connection_image);
+        painter.translate(-blockRect.x() * 16, -blockRect.y() * 16);
+        paintBlocks(&painter, blockRect, fromLayout);
+        painter.end();
+    }
     // connection_image = connection_image.convertToFormat(QImage::Format_Grayscale8);
-    return QPixmap::fromImage(connection_image);
+    QPixmap pixmap = QPixmap::fromImage(connection_image);
+    connectionStrips.insert(connection.direction, ConnectionStrip{ blockRect, layout, layout->blocksRevision(), primaryTileset, secondaryTileset,
+                                                      primaryRevision, secondaryRevision, metatileLayerOrder, metatileLayerOpacity, pixmap });
+    return pixmap;
 }
 
 void Map::setNewDimensionsBlockdata(int newWidth, int newHeight) {
@@ -274,6 +308,7 @@ void Map::setNewDimensionsBlockdata(int newWidth, int newHeight) {
         }
 
     layout->blockdata = newBlockdata;
+    markAllBlocksDirty();
 }
 
 void Map::setNewBorderDimensionsBlockdata(int newWidth, int newHeight) {
@@ -293,6 +328,7 @@ void Map::setNewBorderDimensionsBlockdata(int newWidth, int newHeight) {
         }
 
     layout->border = newBlockdata;
+    layout->markBlocksChanged();
 }
 
 void Map::setDimensions(int newWidth, int newHeight, bool setNewBlockdata) {
@@ -300,8 +336,9 @@ void Map::setDimensions(int newWidth, int newHeight, bool setNewBlockdata) {
         setNewDimensionsBlockdata(newWidth, newHeight);
     }
 
-    layout->width = QString::number(newWidth);
-    layout->height = QString::number(newHeight);
+    layout->width = newWidth;
+    layout->height = newHeight;
+    layout->markBlocksChanged();
 
     emit mapChanged(this);
     emit mapDimensionsChanged(QSize(getWidth(), getHeight()));
@@ -312,87 +349,171 @@ void Map::setBorderDimensions(int newWidth, int newHeight, bool setNewBlockdata)
         setNewBorderDimensionsBlockdata(newWidth, newHeight);
     }
 
-    layout->border_width = QString::number(newWidth);
-    layout->border_height = QString::number(newHeight);
+    layout->border_width = newWidth;
+    layout->border_height = newHeight;
+    layout->markBlocksChanged();
 
     emit mapChanged(this);
 }
 
-bool Map::getBlock(int x, int y, Block* out) {
-    if (x >= 0 && x < getWidth() && y >= 0 && y < getHeight()) {
-        int i = y * getWidth() + x;
-        *out = layout->blockdata.value(i);
+bool Map::isWithinBounds(int x, int y) const {
+    return x >= 0 && x < layout->width && y >= 0 && y < layout->height;
+}
+
+bool Map::getBlock(int x, int y, Block* out) const {
+    if (isWithinBounds(x, y)) {
+        *out = layout->blockdata.value(y * layout->width + x);
         return true;
     }
     return false;
 }
 
-void Map::setBlock(int x, int y, Block block, bool enableScriptCallback) {
-    int i = y * getWidth() + x;
+void Map::setBlock(int x, int y, Block block, bool enableScriptCallback, BlockdataDiff* changes) {
+    int i = y * layout->width + x;
     if (i < layout->blockdata.size()) {
         Block prevBlock = layout->blockdata.at(i);
-        layout->blockdata.replace(i, block);
+        layout->blockdata[i] = block;
+        markBlocksDirty(QRect(x, y, 1, 1));
+        if (changes) {
+            changes->record(i, prevBlock, block);
+        }
         if (enableScriptCallback) {
             Scripting::cb_MetatileChanged(x, y, prevBlock, block);
         }
     }
 }
 
-void Map::_floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation) {
-    QList<QPoint> todo;
-    todo.append(QPoint(x, y));
-    while (todo.length()) {
-        QPoint point = todo.takeAt(0);
-        x = point.x();
-        y = point.y();
-        Block block;
-        if (!getBlock(x, y, &block)) {
+Block Map::getBlockUnchecked(int x, int y) const {
+    return layout->blockdata.at(y * layout->width + x);
+}
+
+void Map::setBlockUnchecked(int x, int y, Block block) {
+    layout->blockdata[y * layout->width + x] = block;
+    markBlocksDirty(QRect(x, y, 1, 1));
+}
+
+QVector<uint16_t> Map::getRawBlocks(const QRect& rect) const {
+    QVector<uint16_t> rawValues(qMax(rect.width(), 0) * qMax(rect.height(), 0), 0);
+    QRect bounds = rect & QRect(0, 0, getWidth(), getHeight());
+    const Block* blocks = layout->blockdata.constData();
+    for (int y = bounds.top(); y <= bounds.bottom(); y++) {
+        int src = y * layout->width;
+        int dest = (y - rect.y()) * rect.width() - rect.x();
+        for (int x = bounds.left(); x <= bounds.right(); x++) {
+            rawValues[dest + x] = blocks[src + x].rawValue();
+        }
+    }
+    return rawValues;
+}
+
+void Map::setRawBlocks(const QRect& rect, const QVector<uint16_t>& rawValues, QVector<uint16_t>* prevValues) {
+    if (prevValues)
+        *prevValues = getRawBlocks(rect);
+    QRect bounds = rect & QRect(0, 0, getWidth(), getHeight());
+    if (bounds.isEmpty() || rawValues.length() < rect.width() * rect.height())
+        return;
+    Block* blocks = layout->blockdata.data();
+    for (int y = bounds.top(); y <= bounds.bottom(); y++) {
+        int src = (y - rect.y()) * rect.width() - rect.x();
+        int dest = y * layout->width;
+        for (int x = bounds.left(); x <= bounds.right(); x++) {
+            blocks[dest + x] = Block(rawValues.at(src + x));
+        }
+    }
+    markBlocksDirty(bounds);
+}
+
+QVector<int> Map::getConnectedBlocks(int x, int y, const std::function<bool(const Block&)>& matches) const {
+    QVector<int> region;
+    if (!isWithinBounds(x, y))
+        return region;
+
+    const int width = getWidth();
+    const int height = getHeight();
+    const int numBlocks = qMin(width * height, layout->blockdata.size());
+    const Block* blocks = layout->blockdata.constData();
+    QBitArray visited(width * height);
+    auto isOpen = [&](int i) { return i < numBlocks && !visited.testBit(i) && matches(blocks[i]); };
+
+    // Each seed is widened into the full horizontal span it belongs to. The rows above and below the span
+    // are then seeded once per run of open blocks, so every block is only looked at a few times.
+    QVector<QPoint> seeds;
+    seeds.append(QPoint(x, y));
+    while (!seeds.isEmpty()) {
+        QPoint seed = seeds.takeLast();
+        int row = seed.y() * width;
+        if (!isOpen(row + seed.x()))
             continue;
+
+        int left = seed.x();
+        while (left > 0 && isOpen(row + left - 1))
+            left--;
+        int right = seed.x();
+        while (right < width - 1 && isOpen(row + right + 1))
+            right++;
+        for (int i = left; i <= right; i++) {
+            visited.setBit(row + i);
+            region.append(row + i);
         }
 
-        uint old_coll = block.collision;
-        uint old_elev = block.elevation;
-        if (old_coll == collision && old_elev == elevation) {
-            continue;
+        for (int neighborY : { seed.y() - 1, seed.y() + 1 }) {
+            if (neighborY < 0 || neighborY >= height)
+                continue;
+            int neighborRow = neighborY * width;
+            bool inRun = false;
+            for (int i = left; i <= right; i++) {
+                bool open = isOpen(neighborRow + i);
+                if (open && !inRun)
+                    seeds.append(QPoint(i, neighborY));
+                inRun = open;
+            }
         }
+    }
+    return region;
+}
 
+void Map::_floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation, BlockdataDiff* changes) {
+    Block block;
+    if (!getBlock(x, y, &block))
+        return;
+
+    uint old_coll = block.collision;
+    uint old_elev = block.elevation;
+    if (old_coll == collision && old_elev == elevation)
+        return;
+
+    int width = getWidth();
+    auto sameCollision = [old_coll, old_elev](const Block& other) { return other.collision == old_coll && other.elevation == old_elev; };
+    for (int i : getConnectedBlocks(x, y, sameCollision)) {
+        block = layout->blockdata.at(i);
         block.collision = collision;
         block.elevation = elevation;
-        setBlock(x, y, block, true);
-        if (getBlock(x + 1, y, &block) && block.collision == old_coll && block.elevation == old_elev) {
-            todo.append(QPoint(x + 1, y));
-        }
-        if (getBlock(x - 1, y, &block) && block.collision == old_coll && block.elevation == old_elev) {
-            todo.append(QPoint(x - 1, y));
-        }
-        if (getBlock(x, y + 1, &block) && block.collision == old_coll && block.elevation == old_elev) {
-            todo.append(QPoint(x, y + 1));
-        }
-        if (getBlock(x, y - 1, &block) && block.collision == old_coll && block.elevation == old_elev) {
-            todo.append(QPoint(x, y - 1));
-        }
+        setBlock(i % width, i / width, block, true, changes);
     }
 }
 
-void Map::floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation) {
+void Map::floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation, BlockdataDiff* changes) {
     Block block;
     if (getBlock(x, y, &block) && (block.collision != collision || block.elevation != elevation)) {
-        _floodFillCollisionElevation(x, y, collision, elevation);
+        _floodFillCollisionElevation(x, y, collision, elevation, changes);
     }
 }
 
-void Map::magicFillCollisionElevation(int initialX, int initialY, uint16_t collision, uint16_t elevation) {
+void Map::magicFillCollisionElevation(int initialX, int initialY, uint16_t collision, uint16_t elevation, BlockdataDiff* changes) {
     Block block;
     if (getBlock(initialX, initialY, &block) && (block.collision != collision || block.elevation != elevation)) {
         uint old_coll = block.collision;
         uint old_elev = block.elevation;
 
-        for (int y = 0; y < getHeight(); y++) {
-            for (int x = 0; x < getWidth(); x++) {
-                if (getBlock(x, y, &block) && block.collision == old_coll && block.elevation == old_elev) {
+        int width = getWidth();
+        int height = getHeight();
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                block = getBlockUnchecked(x, y);
+                if (block.collision == old_coll && block.elevation == old_elev) {
                     block.collision = collision;
                     block.elevation = elevation;
-                    setBlock(x, y, block, true);
+                    setBlock(x, y, block, true, changes);
                 }
             }
         }
@@ -442,3 +563,88 @@ void Map::addEvent(Event* event) {
 bool Map::hasUnsavedChanges() {
     return !editHistory.isClean() || !isPersistedToFile;
 }
+
+void Map::markSaved() {
+    savedContentHash = contentHash();
+    savedBlocksRevision = layout ? layout->blocksRevision() : 0;
+}
+
+bool Map::needsSave() {
+    if (hasUnsavedChanges())
+        return true;
+    if (layout && layout->blocksRevision() != savedBlocksRevision)
+        return true;
+    return contentHash() != savedContentHash;
+}
+
+QByteArray Map::contentHash() const {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto add = [&hash](const QString& value) {
+        hash.addData(value.toUtf8());
+        hash.addData("\0", 1);
+    };
+
+    QStringList header = { name, constantName, song, layoutId, location, requiresFlash, isFlyable, weather, type, show_location,
+        allowRunning, allowBiking, allowEscapeRope, QString::number(floorNumber), battle_scene, sharedEventsMap, sharedScriptsMap };
+    for (const QString& value : header) {
+        add(value);
+    }
+    for (auto it = customHeaders.constBegin(); it != customHeaders.constEnd(); it++) {
+        add(it.key());
+        add(it.value());
+    }
+    for (MapConnection* connection : connections) {
+        add(connection->direction);
+        add(connection->offset);
+        add(connection->map_name);
+    }
+    for (Event* event : getAllEvents()) {
+        add(event->get("event_type"));
+        add(QString("%1,%2,%3").arg(event->x()).arg(event->y()).arg(event->elevation()));
+        for (auto it = event->values.constBegin(); it != event->values.constEnd(); it++) {
+            add(it.key());
+            add(it.value());
+        }
+        for (auto it = event->customValues.constBegin(); it != event->customValues.constEnd(); it++) {
+            add(it.key());
+            add(it.value());
+        }
+    }
+    return hash.result();
+}
+
+static qint64 commandMemoryUsage(const QUndoCommand* command) {
+    switch (command->id()) {
+    case CommandId::ID_PaintMetatile:
+    case CommandId::ID_BucketFillMetatile:
+    case CommandId::ID_MagicFillMetatile:
+    case CommandId::ID_PaintCollision:
+    case CommandId::ID_BucketFillCollision:
+    case CommandId::ID_MagicFillCollision:
+        return static_cast<const PaintMetatile*>(command)->memoryUsage();
+    case CommandId::ID_ShiftMetatiles:
+        return static_cast<const ShiftMetatiles*>(command)->memoryUsage();
+    case CommandId::ID_ResizeMap:
+        return static_cast<const ResizeMap*>(command)->memoryUsage();
+    case CommandId::ID_PaintBorder:
+        return static_cast<const PaintBorder*>(command)->memoryUsage();
+    case CommandId::ID_ScriptEditMap:
+        return static_cast<const ScriptEditMap*>(command)->memoryUsage();
+    default:
+        // Event commands hold little besides pointers to their events, so charge a rough fixed size.
+        return 256;
+    }
+}
+
+qint64 Map::memoryUsage() const {
+    qint64 bytes = qint64(image.bytesPerLine()) * image.height() + qint64(collision_image.bytesPerLine()) * collision_image.height();
+    bytes += qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    bytes += qint64(collision_pixmap.width()) * collision_pixmap.height() * collision_pixmap.depth() / 8;
+    for (const ConnectionStrip& strip : connectionStrips) {
+        bytes += qint64(strip.pixmap.width()) * strip.pixmap.height() * strip.pixmap.depth() / 8;
+    }
+    for (int i = 0; i < editHistory.count(); i++) {
+        bytes += commandMemoryUsage(editHistory.command(i));
+    }
+    return bytes;
+}
@@ -1,6 +1,7 @@
 #include "maplayout.h"
 
 #include <QRegularExpression>
+#include <QAtomicInteger>
 
 QString MapLayout::layoutConstantFromName(QString mapName) {
     // Transform map names of the form 'GraniteCave_B1F` into layout constants like 'LAYOUT_GRANITE_CAVE_B1F'.
@@ -14,3 +15,30 @@ QString MapLayout::layoutConstantFromName(QString mapName) {
 
     return constantName;
 }
+
+quint64 MapLayout::nextBlocksRevision() {
+    static QAtomicInteger<quint64> counter(0);
+    return ++counter;
+}
+
+void MapLayout::markBlocksChanged() {
+    this->blocksRevision_ = nextBlocksRevision();
+}
+
+qint64 MapLayout::memoryUsage() const {
+    qint64 blocks = blockdata.size() + border.size() + cached_border.size() + lastCommitMapBlocks.blocks.size();
+    qint64 bytes = blocks * sizeof(Block) + qint64(border_image.bytesPerLine()) * border_image.height();
+    bytes += qint64(border_pixmap.width()) * border_pixmap.height() * border_pixmap.depth() / 8;
+    return bytes;
+}
+
+void MapLayout::releaseData() {
+    blockdata = Blockdata();
+    border = Blockdata();
+    cached_border = Blockdata();
+    lastCommitMapBlocks.blocks = Blockdata();
+    lastCommitMapBlocks.dimensions = QSize();
+    border_image = QImage();
+    border_pixmap = QPixmap();
+    markBlocksChanged();
+}
@@ -4,13 +4,68 @@
 #include <QRegularExpression>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QStack>
+#include <QFileInfo>
 
 void ParseUtil::set_root(const QString& dir) {
     this->root = dir;
+    clearFileCache();
+}
+
+void ParseUtil::invalidateFile(const QString& path) {
+    QMutexLocker locker(&fileCacheMutex);
+    fileCache.remove(path);
+}
+
+void ParseUtil::clearFileCache() {
+    QMutexLocker locker(&fileCacheMutex);
+    fileCache.clear();
+}
+
+ParseUtil::CachedFile ParseUtil::getCachedFile(const QString& path) {
+    QFileInfo info(path);
+    bool exists = info.exists();
+    QDateTime lastModified = info.lastModified();
+    qint64 size = exists ? info.size() : -1;
+
+    {
+        QMutexLocker locker(&fileCacheMutex);
+        auto it = fileCache.constFind(path);
+        if (exists && it != fileCache.constEnd() && it->lastModified == lastModified && it->size == size) {
+            return it.value();
+        }
+    }
+
+    CachedFile cached;
+    cached.lastModified = lastModified;
+    cached.size = size;
+    cached.text = readTextFile(path);
+
+    QMutexLocker locker(&fileCacheMutex);
+    fileCache.insert(path, cached);
+    return cached;
+}
+
+// Saves parse results for a cached file, unless the file changed while it was being parsed.
+void ParseUtil::storeCachedFile(const QString& path, const CachedFile& cached) {
+    QMutexLocker locker(&fileCacheMutex);
+    auto it = fileCache.find(path);
+    if (it == fileCache.end() || it->lastModified != cached.lastModified || it->size != cached.size) {
+        return;
+    }
+    if (cached.asmParsed) {
+        it->asmMacros = cached.asmMacros;
+        it->asmParsed = true;
+    }
+    if (cached.definesParsed) {
+        it->defineExpressions = cached.defineExpressions;
+        it->definesParsed = true;
+    }
 }
 
 void ParseUtil::error(const QString& message, const QString& expression) {
+    const ErrorContext& context = errorContext.localData();
+    const QString& text = context.text;
+    const QString& file = context.file;
     QStringList lines = text.split(QRegularExpression("[\r\n]"));
     int lineNum = 0, colNum = 0;
     for (QString line : lines) {
@@ -43,10 +98,14 @@ int ParseUtil::textFileLineCount(const QString& path) {
 }
 
 QList<QStringList> ParseUtil::parseAsm(const QString& filename) {
-    QList<QStringList> parsed;
+    QString filepath = root + '/' + filename;
+    CachedFile cached = getCachedFile(filepath);
+    if (cached.asmParsed) {
+        return cached.asmMacros;
+    }
 
-    text = readTextFile(root + '/' + filename);
-    const QStringList lines = removeLineComments(text, "@").split('\n');
+    QList<QStringList> parsed;
+    const QStringList lines = removeLineComments(cached.text, "@").split('\n');
     for (const auto& line : lines) {
         const QString trimmedLine = line.trimmed();
         if (trimmedLine.isEmpty()) {
@@ -67,141 +126,274 @@ QList<QStringList> ParseUtil::parseAsm(const QString& filename) {
             parsed.append(params);
         }
     }
+    cached.asmMacros = parsed;
+    cached.asmParsed = true;
+    storeCachedFile(filepath, cached);
     return parsed;
 }
 
-int ParseUtil::evaluateDefine(const QString& define, const QMap<QString, int>& knownDefines) {
-    QList<Token> tokens = tokenizeExpression(define, knownDefines);
-    QList<Token> postfixExpression = generatePostfix(tokens);
-    return evaluatePostfix(postfixExpression);
+struct ParseUtil::DefineExpression {
+    const QString& text;
+    const QHash<QString, int>& symbols;
+    const QChar* cur;
+    const QChar* end;
+    bool failed;
+
+    DefineExpression(const QString& text, const QHash<QString, int>& symbols)
+        : text(text), symbols(symbols), cur(text.constData()), end(text.constData() + text.length()), failed(false) {}
+
+    void skipSpace() {
+        while (cur < end && cur->isSpace())
+            cur++;
+    }
+    bool atEnd() const { return cur >= end; }
+    QString remaining() const { return QString(cur, static_cast<int>(end - cur)); }
+};
+
+static bool isIdentifierChar(QChar c) {
+    return c.isLetterOrNumber() || c == '_';
+}
+
+static bool isOperatorChar(QChar c) {
+    return QStringLiteral("+-*/%<>|^&=!~?:").contains(c);
+}
+
+// Returns true if 'c' can begin an operand, including one preceded by a unary operator.
+static bool startsOperand(QChar c) {
+    return isIdentifierChar(c) || c == '(' || c == '-' || c == '+' || c == '~' || c == '!';
 }
 
-QList<Token> ParseUtil::tokenizeExpression(QString expression, const QMap<QString, int>& knownIdentifiers) {
-    QList<Token> tokens;
+// Returns true if 'cur' is just past the '(' of a C-style cast, e.g. '(u16)' or '(unsigned int)', that is
+// followed by an operand. Casts don't change the values porymap cares about, so they can be skipped.
+// 'castEnd' is set to the character after the closing ')'.
+static bool isCast(const QChar* cur, const QChar* end, const QHash<QString, int>& symbols, const QChar** castEnd) {
+    bool sawType = false;
+    for (;;) {
+        while (cur < end && cur->isSpace())
+            cur++;
+        if (cur >= end)
+            return false;
+        if (*cur == ')')
+            break;
+        if (!isIdentifierChar(*cur) || cur->isDigit())
+            return false;
+        const QChar* start = cur;
+        while (cur < end && isIdentifierChar(*cur))
+            cur++;
+        if (symbols.contains(QString(start, static_cast<int>(cur - start))))
+            return false;
+        sawType = true;
+    }
+    if (!sawType)
+        return false;
+    *castEnd = ++cur;
+    while (cur < end && cur->isSpace())
+        cur++;
+    return cur < end && startsOperand(*cur);
+}
 
-    QStringList tokenTypes = (QStringList() << "hex"
-                                            << "decimal"
-                                            << "identifier"
-                                            << "operator"
-                                            << "leftparen"
-                                            << "rightparen");
-    QRegularExpression re(
-        "^(?<hex>0x[0-9a-fA-F]+)|(?<decimal>[0-9]+)|(?<identifier>[a-zA-Z_0-9]+)|(?<operator>[+\\-*\\/<>|^%]+)|(?<leftparen>\\()|(?<rightparen>\\))");
+// Returns the binding strength of the binary operator at 'cur', or -1 if there is none.
+// 'length' is set to the number of characters the operator spans, including unsupported ones.
+static int binaryOperatorPrecedence(const QChar* cur, const QChar* end, int* length) {
+    const QChar c = *cur;
+    const QChar next = (cur + 1 < end) ? *(cur + 1) : QChar();
+    *length = 1;
+    if (c == '*' || c == '/' || c == '%') return 10;
+    if (c == '+' || c == '-') return 9;
+    if ((c == '<' || c == '>') && next == c) {
+        *length = 2;
+        return (cur + 2 < end && *(cur + 2) == '=') ? -1 : 8;
+    }
+    if (c == '&' && next != '&' && next != '=') return 5;
+    if (c == '^' && next != '=') return 4;
+    if (c == '|' && next != '|' && next != '=') return 3;
+
+    *length = 0;
+    while (cur + *length < end && isOperatorChar(*(cur + *length)))
+        (*length)++;
+    return -1;
+}
+
+int ParseUtil::evaluateDefine(const QString& define, const QHash<QString, int>& knownDefines) {
+    DefineExpression expr(define, knownDefines);
+    expr.skipSpace();
+    if (expr.atEnd())
+        return 0;
+
+    int value = evaluateBinary(expr, 0);
+    if (!expr.failed && !expr.atEnd() && *expr.cur == ')') {
+        logError("Mismatched parentheses detected in expression!");
+    }
+    return value;
+}
 
-    expression = expression.trimmed();
-    while (!expression.isEmpty()) {
-        QRegularExpressionMatch match = re.match(expression);
-        if (!match.hasMatch()) {
-            logWarn(QString("Failed to tokenize expression: '%1'").arg(expression));
+// Precedence climbing over the C binary operators porymap understands.
+// https://en.wikipedia.org/wiki/Operator-precedence_parser#Precedence_climbing_method
+int ParseUtil::evaluateBinary(DefineExpression& expr, int minPrecedence) {
+    int lhs = evaluateUnary(expr);
+    while (!expr.failed) {
+        expr.skipSpace();
+        if (expr.atEnd() || *expr.cur == ')')
             break;
+
+        if (isIdentifierChar(*expr.cur) && !expr.cur->isDigit()) {
+            // An identifier can't follow an operand. Skip it and keep going, like the macro was never there.
+            const QChar* start = expr.cur;
+            while (expr.cur < expr.end && isIdentifierChar(*expr.cur))
+                expr.cur++;
+            QString token(start, static_cast<int>(expr.cur - start));
+            error(QString("unknown token '%1' found in expression '%2'").arg(token).arg(expr.text), expr.text);
+            continue;
         }
-        for (QString tokenType : tokenTypes) {
-            QString token = match.captured(tokenType);
-            if (!token.isEmpty()) {
-                if (tokenType == "identifier") {
-                    if (knownIdentifiers.contains(token)) {
-                        QString actualToken = QString("%1").arg(knownIdentifiers.value(token));
-                        expression = expression.replace(0, token.length(), actualToken);
-                        token = actualToken;
-                        tokenType = "decimal";
-                    } else {
-                        tokenType = "error";
-                        QString message = QString("unknown token '%1' found in expression '%2'").arg(token).arg(expression);
-                        error(message, expression);
-                    }
-                } else if (tokenType == "operator") {
-                    if (!Token::precedenceMap.contains(token)) {
-                        QString message = QString("unsupported postfix operator: '%1'").arg(token);
-                        error(message, expression);
-                    }
-                }
 
-                tokens.append(Token(token, tokenType));
-                expression = expression.remove(0, token.length()).trimmed();
-                break;
+        int length;
+        int precedence = binaryOperatorPrecedence(expr.cur, expr.end, &length);
+        if (precedence < 0) {
+            if (length) {
+                error(QString("unsupported operator: '%1'").arg(QString(expr.cur, length)), expr.text);
+            } else {
+                logWarn(QString("Failed to tokenize expression: '%1'").arg(expr.remaining()));
             }
+            expr.failed = true;
+            break;
         }
-    }
-    return tokens;
-}
-
-QMap<QString, int> Token::precedenceMap
-    = QMap<QString, int>({ { "*", 3 }, { "/", 3 }, { "+", 4 }, { "-", 4 }, { "<<", 5 }, { ">>", 5 }, { "&", 8 }, { "^", 9 }, { "|", 10 } });
-
-// Shunting-yard algorithm for generating postfix notation.
-// https://en.wikipedia.org/wiki/Shunting-yard_algorithm
-QList<Token> ParseUtil::generatePostfix(const QList<Token>& tokens) {
-    QList<Token> output;
-    QStack<Token> operatorStack;
-    for (Token token : tokens) {
-        if (token.type == TokenClass::Number) {
-            output.append(token);
-        } else if (token.value == "(") {
-            operatorStack.push(token);
-        } else if (token.value == ")") {
-            while (!operatorStack.empty() && operatorStack.top().value != "(") {
-                output.append(operatorStack.pop());
-            }
-            if (!operatorStack.empty()) {
-                // pop the left parenthesis token
-                operatorStack.pop();
+        if (precedence < minPrecedence)
+            break;
+
+        const QChar op = *expr.cur;
+        expr.cur += length;
+        int rhs = evaluateBinary(expr, precedence + 1);
+
+        // Wrap on overflow like the compiler would rather than invoking undefined behavior.
+        const unsigned a = static_cast<unsigned>(lhs), b = static_cast<unsigned>(rhs);
+        switch (op.unicode()) {
+        case '*': lhs = static_cast<int>(a * b); break;
+        case '+': lhs = static_cast<int>(a + b); break;
+        case '-': lhs = static_cast<int>(a - b); break;
+        case '<': lhs = static_cast<int>(a << (b & 31)); break;
+        case '>': lhs = lhs >> (b & 31); break;
+        case '&': lhs = lhs & rhs; break;
+        case '^': lhs = lhs ^ rhs; break;
+        case '|': lhs = lhs | rhs; break;
+        case '/':
+        case '%':
+            if (rhs == 0) {
+                error(QString("division by zero in expression '%1'").arg(expr.text), expr.text);
+                lhs = 0;
+            } else if (rhs == -1) {
+                lhs = (op == '/') ? static_cast<int>(0u - a) : 0;
             } else {
-                logError("Mismatched parentheses detected in expression!");
-            }
-        } else {
-            // token is an operator
-            while (!operatorStack.isEmpty() && operatorStack.top().operatorPrecedence <= token.operatorPrecedence && operatorStack.top().value != "(") {
-                output.append(operatorStack.pop());
+                lhs = (op == '/') ? lhs / rhs : lhs % rhs;
             }
-            operatorStack.push(token);
+            break;
         }
     }
+    return lhs;
+}
+
+int ParseUtil::evaluateUnary(DefineExpression& expr) {
+    expr.skipSpace();
+    if (expr.atEnd()) {
+        error(QString("missing operand in expression '%1'").arg(expr.text), expr.text);
+        return 0;
+    }
+
+    const QChar c = *expr.cur;
+    if (c == '-' || c == '+' || c == '~' || c == '!') {
+        expr.cur++;
+        int operand = evaluateUnary(expr);
+        if (c == '-') return static_cast<int>(0u - static_cast<unsigned>(operand));
+        if (c == '~') return ~operand;
+        if (c == '!') return !operand;
+        return operand;
+    }
 
-    while (!operatorStack.isEmpty()) {
-        if (operatorStack.top().value == "(" || operatorStack.top().value == ")") {
+    if (c == '(') {
+        expr.cur++;
+        const QChar* castEnd;
+        if (isCast(expr.cur, expr.end, expr.symbols, &castEnd)) {
+            expr.cur = castEnd;
+            return evaluateUnary(expr);
+        }
+        int value = evaluateBinary(expr, 0);
+        expr.skipSpace();
+        if (!expr.atEnd() && *expr.cur == ')') {
+            expr.cur++;
+        } else if (!expr.failed) {
             logError("Mismatched parentheses detected in expression!");
-        } else {
-            output.append(operatorStack.pop());
         }
+        return value;
     }
 
-    return output;
-}
-
-// Evaluate postfix expression.
-// https://en.wikipedia.org/wiki/Reverse_Polish_notation#Postfix_evaluation_algorithm
-int ParseUtil::evaluatePostfix(const QList<Token>& postfix) {
-    QStack<Token> stack;
-    for (Token token : postfix) {
-        if (token.type == TokenClass::Operator && stack.size() > 1) {
-            int op2 = stack.pop().value.toInt(nullptr, 0);
-            int op1 = stack.pop().value.toInt(nullptr, 0);
-            int result = 0;
-            if (token.value == "*") {
-                result = op1 * op2;
-            } else if (token.value == "/") {
-                result = op1 / op2;
-            } else if (token.value == "+") {
-                result = op1 + op2;
-            } else if (token.value == "-") {
-                result = op1 - op2;
-            } else if (token.value == "<<") {
-                result = op1 << op2;
-            } else if (token.value == ">>") {
-                result = op1 >> op2;
-            } else if (token.value == "&") {
-                result = op1 & op2;
-            } else if (token.value == "^") {
-                result = op1 ^ op2;
-            } else if (token.value == "|") {
-                result = op1 | op2;
+    if (c.isDigit()) {
+        const QChar* start = expr.cur;
+        unsigned base = 10;
+        if (c == '0' && expr.cur + 1 < expr.end && (*(expr.cur + 1) == 'x' || *(expr.cur + 1) == 'X')) {
+            base = 16;
+            expr.cur += 2;
+        } else if (c == '0') {
+            base = 8;
+        }
+        unsigned value = 0;
+        bool valid = true;
+        for (; expr.cur < expr.end && isIdentifierChar(*expr.cur); expr.cur++) {
+            const QChar d = *expr.cur;
+            unsigned digit;
+            if (d >= '0' && d <= '9') digit = d.unicode() - '0';
+            else if (d >= 'a' && d <= 'f') digit = d.unicode() - 'a' + 10;
+            else if (d >= 'A' && d <= 'F') digit = d.unicode() - 'A' + 10;
+            else break;
+            if (digit >= base) {
+                valid = false;
+                break;
             }
-            stack.push(Token(QString("%1").arg(result), "decimal"));
-        } else if (token.type != TokenClass::Error) {
-            stack.push(token);
-        } // else ignore errored tokens, we have already warned the user.
+            value = value * base + digit;
+        }
+        // Integer suffixes (e.g. 1u, 0x10UL) don't change the value.
+        while (expr.cur < expr.end && (*expr.cur == 'u' || *expr.cur == 'U' || *expr.cur == 'l' || *expr.cur == 'L'))
+            expr.cur++;
+        if (!valid || (expr.cur < expr.end && isIdentifierChar(*expr.cur))) {
+            while (expr.cur < expr.end && isIdentifierChar(*expr.cur))
+                expr.cur++;
+            QString token(start, static_cast<int>(expr.cur - start));
+            error(QString("unknown token '%1' found in expression '%2'").arg(token).arg(expr.text), expr.text);
+            return 0;
+        }
+        return static_cast<int>(value);
     }
-    return stack.size() ? stack.pop().value.toInt(nullptr, 0) : 0;
+
+    if (isIdentifierChar(c)) {
+        const QChar* start = expr.cur;
+        while (expr.cur < expr.end && isIdentifierChar(*expr.cur))
+            expr.cur++;
+        QString token(start, static_cast<int>(expr.cur - start));
+        auto it = expr.symbols.constFind(token);
+        if (it != expr.symbols.constEnd())
+            return it.value();
+        error(QString("unknown token '%1' found in expression '%2'").arg(token).arg(expr.text), expr.text);
+
+        // Unknown identifiers are ignored if an operand follows, e.g. a function-like macro wrapping a value.
+        expr.skipSpace();
+        if (!expr.atEnd() && (isIdentifierChar(*expr.cur) || *expr.cur == '('))
+            return evaluateUnary(expr);
+        return 0;
+    }
+
+    if (c == ')') {
+        error(QString("missing operand in expression '%1'").arg(expr.text), expr.text);
+        return 0;
+    }
+
+    if (isOperatorChar(c)) {
+        int length = 0;
+        while (expr.cur + length < expr.end && isOperatorChar(*(expr.cur + length)))
+            length++;
+        error(QString("unsupported operator: '%1'").arg(QString(expr.cur, length)), expr.text);
+    } else {
+        logWarn(QString("Failed to tokenize expression: '%1'").arg(expr.remaining()));
+    }
+    expr.failed = true;
+    return 0;
 }
 
 QString ParseUtil::readCIncbin(const QString& filename, const QString& label) {
@@ -211,7 +403,7 @@ QString ParseUtil::readCIncbin(const QString& filename, const QString& label) {
         return path;
     }
 
-    text = readTextFile(root + "/" + filename);
+    QString text = getCachedFile(root + "/" + filename).text;
 
     QRegExp* re = new QRegExp(QString("\\b%1\\b"
                                       "\\s*\\[?\\s*\\]?\\s*=\\s*"
@@ -227,41 +419,60 @@ QString ParseUtil::readCIncbin(const QString& filename, const QString& label) {
     return path;
 }
 
-QMap<QString, int> ParseUtil::readCDefines(const QString& filename, const QStringList& prefixes, QMap<QString, int> allDefines) {
+QMap<QString, int> ParseUtil::readCDefines(const QString& filename, const QStringList& prefixes, const QMap<QString, int>& knownDefines) {
     QMap<QString, int> filteredDefines;
 
-    file = filename;
-
-    if (file.isEmpty()) {
+    if (filename.isEmpty()) {
         return filteredDefines;
     }
 
-    QString filepath = root + "/" + file;
-    text = readTextFile(filepath);
+    QString filepath = root + "/" + filename;
+    CachedFile cached = getCachedFile(filepath);
+    errorContext.setLocalData({ filename, cached.text });
 
-    if (text.isNull()) {
+    if (cached.text.isNull()) {
         logError(QString("Failed to read C defines file: '%1'").arg(filepath));
         return filteredDefines;
     }
 
-    text.replace(QRegularExpression("(//.*)|(\\/+\\*+[^*]*\\*+\\/+)"), "");
-    text.replace(QRegularExpression("(\\\\\\s+)"), "");
+    if (!cached.definesParsed) {
+        QString stripped = cached.text;
+        stripped.replace(QRegularExpression("(//.*)|(\\/+\\*+[^*]*\\*+\\/+)"), "");
+        stripped.replace(QRegularExpression("(\\\\\\s+)"), "");
+
+        QRegularExpression re("#define\\s+(?<defineName>\\w+)[^\\S\\n]+(?<defineValue>.+)");
+        QRegularExpressionMatchIterator iter = re.globalMatch(stripped);
+        while (iter.hasNext()) {
+            QRegularExpressionMatch match = iter.next();
+            QString expression = match.captured("defineValue");
+            if (expression == " ")
+                continue;
+            cached.defineExpressions.append(qMakePair(match.captured("defineName"), expression));
+        }
+        cached.definesParsed = true;
+        storeCachedFile(filepath, cached);
+    }
+
+    QHash<QString, int> allDefines;
+    allDefines.reserve(knownDefines.size() + cached.defineExpressions.size() + 2);
+    for (auto it = knownDefines.constBegin(); it != knownDefines.constEnd(); it++)
+        allDefines.insert(it.key(), it.value());
     allDefines.insert("FALSE", 0);
     allDefines.insert("TRUE", 1);
 
-    QRegularExpression re("#define\\s+(?<defineName>\\w+)[^\\S\\n]+(?<defineValue>.+)");
-    QRegularExpressionMatchIterator iter = re.globalMatch(text);
-    while (iter.hasNext()) {
-        QRegularExpressionMatch match = iter.next();
-        QString name = match.captured("defineName");
-        QString expression = match.captured("defineValue");
-        if (expression == " ")
-            continue;
+    QList<QRegularExpression> prefixPatterns;
+    for (const QString& prefix : prefixes)
+        prefixPatterns.append(QRegularExpression(prefix));
+
+    for (const auto& define : cached.defineExpressions) {
+        const QString& name = define.first;
+        const QString& expression = define.second;
         int value = evaluateDefine(expression, allDefines);
         allDefines.insert(name, value);
-        for (QString prefix : prefixes) {
-            if (name.startsWith(prefix) || QRegularExpression(prefix).match(name).hasMatch()) {
+        for (int i = 0; i < prefixes.length(); i++) {
+            if (name.startsWith(prefixes.at(i)) || prefixPatterns.at(i).match(name).hasMatch()) {
                 filteredDefines.insert(name, value);
+                break;
             }
         }
     }
@@ -287,28 +498,65 @@ QStringList ParseUtil::readCArray(const QString& filename, const QString& label)
         return list;
     }
 
-    file = filename;
-    text = readTextFile(root + "/" + filename);
+    QString text = getCachedFile(root + "/" + filename).text;
 
     QRegularExpression re(QString(R"(\b%1\b\s*(\[?[^\]]*\])?\s*=\s*\{([^\}]*)\})").arg(label));
     QRegularExpressionMatch match = re.match(text);
 
     if (match.hasMatch()) {
-        QString body = match.captured(2);
-        QStringList split = body.split(',');
-        for (QString item : split) {
-            item = item.trimmed();
-            if (!item.contains(QRegularExpression("[^A-Za-z0-9_&()\\s]")))
-                list.append(item);
-            // do not print error info here because this is called dozens of times
-        }
+        list = splitCArrayBody(match.captured(2));
+    }
+
+    return list;
+}
+
+QHash<QString, QStringList> ParseUtil::readCArrays(const QString& filename) {
+    QHash<QString, QStringList> arrays;
+    QString text = getCachedFile(root + "/" + filename).text;
+
+    static const QRegularExpression re(R"(\b(\w+)\s*(\[[^\]]*\])?\s*=\s*\{([^\}]*)\})");
+    QRegularExpressionMatchIterator iter = re.globalMatch(text);
+    while (iter.hasNext()) {
+        QRegularExpressionMatch match = iter.next();
+        QString label = match.captured(1);
+        if (!arrays.contains(label))
+            arrays.insert(label, splitCArrayBody(match.captured(3)));
     }
+    return arrays;
+}
 
+QHash<QString, QString> ParseUtil::readCIncbins(const QString& filename) {
+    QHash<QString, QString> paths;
+    QString text = getCachedFile(root + "/" + filename).text;
+
+    static const QRegularExpression re("\\b(\\w+)"
+                                       "\\s*\\[?\\s*\\]?\\s*=\\s*"
+                                       "INCBIN_[US][0-9][0-9]?"
+                                       "\\(\\s*\"([^\"]*)\"\\s*\\)");
+    QRegularExpressionMatchIterator iter = re.globalMatch(text);
+    while (iter.hasNext()) {
+        QRegularExpressionMatch match = iter.next();
+        QString label = match.captured(1);
+        if (!paths.contains(label))
+            paths.insert(label, match.captured(2));
+    }
+    return paths;
+}
+
+QStringList ParseUtil::splitCArrayBody(const QString& body) {
+    QStringList list;
+    static const QRegularExpression invalidChars("[^A-Za-z0-9_&()\\s]");
+    for (QString item : body.split(',')) {
+        item = item.trimmed();
+        if (!item.contains(invalidChars))
+            list.append(item);
+        // do not print error info here because this is called dozens of times
+    }
     return list;
 }
 
 QMap<QString, QString> ParseUtil::readNamedIndexCArray(const QString& filename, const QString& label) {
-    text = readTextFile(root + "/" + filename);
+    QString text = getCachedFile(root + "/" + filename).text;
     QMap<QString, QString> map;
 
     QRegularExpression re_text(QString(R"(\b%1\b\s*(\[?[^\]]*\])?\s*=\s*\{([^\}]*)\})").arg(label));
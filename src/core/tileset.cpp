@@ -6,6 +6,46 @@
 
 #include <QPainter>
 #include <QImage>
+#include <QAtomicInteger>
+
+Tileset::Tileset(const Tileset& other) {
+    *this = other;
+}
+
+Tileset& Tileset::operator=(const Tileset& other) {
+    if (this == &other)
+        return *this;
+
+    this->name = other.name;
+    this->is_compressed = other.is_compressed;
+    this->is_secondary = other.is_secondary;
+    this->padding = other.padding;
+    this->tiles_label = other.tiles_label;
+    this->palettes_label = other.palettes_label;
+    this->metatiles_label = other.metatiles_label;
+    this->metatiles_path = other.metatiles_path;
+    this->callback_label = other.callback_label;
+    this->metatile_attrs_label = other.metatile_attrs_label;
+    this->metatile_attrs_path = other.metatile_attrs_path;
+    this->tilesImagePath = other.tilesImagePath;
+    this->tilesImage = other.tilesImage;
+    this->palettePaths = other.palettePaths;
+    this->tilePixels = other.tilePixels;
+    this->palettes = other.palettes;
+    this->palettePreviews = other.palettePreviews;
+
+    qDeleteAll(this->metatiles);
+    this->metatiles.clear();
+    for (const Metatile* metatile : other.metatiles)
+        this->metatiles.append(new Metatile(*metatile));
+
+    this->markChanged();
+    return *this;
+}
+
+Tileset::~Tileset() {
+    qDeleteAll(this->metatiles);
+}
 
 Tileset* Tileset::getBlockTileset(int metatile_index, Tileset* primaryTileset, Tileset* secondaryTileset) {
     if (metatile_index < Project::getNumMetatilesPrimary()) {
@@ -37,6 +77,33 @@ bool Tileset::metatileIsValid(uint16_t metatileId, Tileset* primaryTileset, Tile
     return true;
 }
 
+const uchar* Tileset::getTilePixels(int localIndex) const {
+    if (localIndex < 0 || localIndex >= this->tileCount()) {
+        return nullptr;
+    }
+    return reinterpret_cast<const uchar*>(this->tilePixels.constData()) + localIndex * 64;
+}
+
+quint64 Tileset::nextRevision() {
+    static QAtomicInteger<quint64> counter(0);
+    return ++counter;
+}
+
+void Tileset::markChanged() {
+    this->revision_ = nextRevision();
+}
+
+qint64 Tileset::memoryUsage() const {
+    qint64 bytes = qint64(this->tilesImage.bytesPerLine()) * this->tilesImage.height() + this->tilePixels.size();
+    for (const Metatile* metatile : this->metatiles) {
+        bytes += sizeof(Metatile) + metatile->tiles.size() * sizeof(Tile);
+    }
+    for (const QList<QRgb>& palette : this->palettes) {
+        bytes += palette.size() * sizeof(QRgb) * 2;
+    }
+    return bytes;
+}
+
 QList<QList<QRgb>> Tileset::getBlockPalettes(Tileset* primaryTileset, Tileset* secondaryTileset, bool useTruePalettes) {
     QList<QList<QRgb>> palettes;
     auto primaryPalettes = useTruePalettes ? primaryTileset->palettes : primaryTileset->palettePreviews;
@@ -339,7 +339,7 @@ void Editor::addNewWildMonGroup(QWidget* window) {
                 if (copyCheckbox->isChecked()) {
                     MonTabWidget* copyFrom = static_cast<MonTabWidget*>(stack->widget(stackIndex));
                     if (copyFrom->isTabEnabled(tabIndex))
-                        header.wildMons.insert(fieldName, copyMonInfoFromTab(copyFrom->tableAt(tabIndex), monField));
+                        header.wildMons.insert(fieldName, copyFrom->encounterDataAt(tabIndex));
                     else
                         header.wildMons.insert(fieldName, getDefaultMonInfo(monField));
                 } else {
@@ -648,9 +648,7 @@ void Editor::saveEncounterTabData() {
             if (!tabWidget->isTabEnabled(fieldIndex++))
                 continue;
 
-            QTableWidget* monTable = static_cast<QTableWidget*>(tabWidget->widget(fieldIndex - 1));
-            QVector<WildPokemon> newWildMons;
-            encounterHeader.wildMons[fieldName] = copyMonInfoFromTab(monTable, monField);
+            encounterHeader.wildMons[fieldName] = tabWidget->encounterDataAt(fieldIndex - 1);
         }
     }
 }
@@ -744,9 +742,9 @@ void Editor::setConnectionItemsVisible(bool visible) {
 }
 
 void Editor::setBorderItemsVisible(bool visible, qreal opacity) {
-    for (QGraphicsPixmapItem* item : borderItems) {
-        item->setVisible(visible);
-        item->setOpacity(opacity);
+    if (border_item) {
+        border_item->setVisible(visible);
+        border_item->setOpacity(opacity);
     }
 }
 
@@ -1335,8 +1333,8 @@ void Editor::displayMapMetatiles() {
 
     int tw = 16;
     int th = 16;
-    scene->setSceneRect(-BORDER_DISTANCE * tw, -BORDER_DISTANCE * th, map_item->pixmap().width() + BORDER_DISTANCE * 2 * tw,
-        map_item->pixmap().height() + BORDER_DISTANCE * 2 * th);
+    scene->setSceneRect(-BORDER_DISTANCE * tw, -BORDER_DISTANCE * th, map_item->boundingRect().width() + BORDER_DISTANCE * 2 * tw,
+        map_item->boundingRect().height() + BORDER_DISTANCE * 2 * th);
 }
 
 void Editor::displayMapMovementPermissions() {
@@ -1543,34 +1541,34 @@ void Editor::maskNonVisibleConnectionTiles() {
 }
 
 void Editor::displayMapBorder() {
-    for (QGraphicsPixmapItem* item : borderItems) {
-        if (item->scene()) {
-            item->scene()->removeItem(item);
+    if (border_item) {
+        if (border_item->scene()) {
+            border_item->scene()->removeItem(border_item);
         }
-        delete item;
+        delete border_item;
+        border_item = nullptr;
     }
-    borderItems.clear();
 
-    int borderWidth = map->getBorderWidth();
-    int borderHeight = map->getBorderHeight();
+    // The border is a single item whose brush tiles the border pixmap, rather than one item per repeat.
+    // The draw distances are multiples of the border size, so the pattern stays aligned with the map origin.
+    // Like drawing one border per repeat, the area is rounded up to whole repeats of the border.
+    int borderWidth = qMax(map->getBorderWidth(), 1);
+    int borderHeight = qMax(map->getBorderHeight(), 1);
     int borderHorzDist = getBorderDrawDistance(borderWidth);
     int borderVertDist = getBorderDrawDistance(borderHeight);
-    QPixmap pixmap = map->renderBorder();
-    for (int y = -borderVertDist; y < map->getHeight() + borderVertDist; y += borderHeight)
-        for (int x = -borderHorzDist; x < map->getWidth() + borderHorzDist; x += borderWidth) {
-            QGraphicsPixmapItem* item = new QGraphicsPixmapItem(pixmap);
-            item->setX(x * 16);
-            item->setY(y * 16);
-            item->setZValue(-2);
-            scene->addItem(item);
-            borderItems.append(item);
-        }
+    int repeatsWide = (map->getWidth() + borderHorzDist * 2 + borderWidth - 1) / borderWidth;
+    int repeatsHigh = (map->getHeight() + borderVertDist * 2 + borderHeight - 1) / borderHeight;
+    QRectF borderRect(-borderHorzDist * 16, -borderVertDist * 16, repeatsWide * borderWidth * 16, repeatsHigh * borderHeight * 16);
+    border_item = new QGraphicsRectItem(borderRect);
+    border_item->setPen(Qt::NoPen);
+    border_item->setBrush(QBrush(map->renderBorder()));
+    border_item->setZValue(-2);
+    scene->addItem(border_item);
 }
 
 void Editor::updateMapBorder() {
-    QPixmap pixmap = this->map->renderBorder(true);
-    for (auto item : this->borderItems) {
-        item->setPixmap(pixmap);
+    if (border_item) {
+        border_item->setBrush(QBrush(this->map->renderBorder(true)));
     }
 }
 
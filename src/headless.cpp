@@ -0,0 +1,394 @@
+#include "headless.h"
+#include "project.h"
+#include "config.h"
+#include "log.h"
+#include "map.h"
+#include "imageproviders.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QPainter>
+#include <QSet>
+#include <QTextStream>
+#include <climits>
+
+static const QStringList baseGameVersions = { "pokeruby", "pokefirered", "pokeemerald" };
+
+// Rendered metatile sheets use the same width as the tileset editor.
+static const int numMetatilesWide = 8;
+
+Headless::Headless(Project* project) : project(project) {
+    phaseTimer.start();
+}
+
+bool Headless::isRequested(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (qstrcmp(argv[i], "--headless") == 0)
+            return true;
+    }
+    return false;
+}
+
+int Headless::run(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders and checks a porymap project without opening the editor.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("project", "The project directory.");
+
+    QCommandLineOption headlessOption("headless", "Run without opening the editor.");
+    QCommandLineOption renderMapOption("render-map", "Render <map> to <map>.png. Can be given more than once.", "map");
+    QCommandLineOption renderAllMapsOption("render-all-maps", "Render every map to <map>.png.");
+    QCommandLineOption renderStitchOption("render-stitch", "Render <map> and every map connected to it to Stitch_From_<map>.png.", "map");
+    QCommandLineOption renderTilesetsOption("render-tilesets", "Render the metatiles of a tileset pair to <primary>_<secondary>.png.", "primary,secondary");
+    QCommandLineOption collisionOption("collision", "Render collision instead of metatiles.");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Write images to <dir>. Defaults to the current directory.", "dir", ".");
+    QCommandLineOption checkOption("check", "Check for missing layouts, bad tileset references, invalid metatile ids and events outside their maps.");
+    QCommandLineOption timingsOption("timings", "Print how long each phase took.");
+    QCommandLineOption baseGameOption("base-game", "Base game (pokeruby, pokefirered or pokeemerald) of a project without a porymap.project.cfg.", "game");
+    parser.addOptions({ headlessOption, renderMapOption, renderAllMapsOption, renderStitchOption, renderTilesetsOption, collisionOption,
+                        outputOption, checkOption, timingsOption, baseGameOption });
+    parser.process(arguments);
+
+    QStringList positional = parser.positionalArguments();
+    if (positional.length() != 1) {
+        logError("Expected exactly one project directory.");
+        parser.showHelp(1);
+    }
+
+    Project project;
+    Headless headless(&project);
+    headless.outputDir = parser.value(outputOption);
+    headless.showCollision = parser.isSet(collisionOption);
+
+    int errors = 0;
+    if (!headless.loadProject(positional.first(), parser.value(baseGameOption))) {
+        errors++;
+    } else {
+        if (parser.isSet(checkOption))
+            errors += headless.checkProject();
+
+        QStringList mapNames = parser.values(renderMapOption);
+        if (parser.isSet(renderAllMapsOption))
+            mapNames = project.mapNames;
+        for (const QString& mapName : mapNames) {
+            Map* map = project.getMap(mapName);
+            if (!map || !headless.saveImage(headless.renderMap(map), mapName + ".png"))
+                errors++;
+            project.evictCaches(QStringList());
+        }
+        if (!mapNames.isEmpty())
+            headless.endPhase("render maps");
+
+        for (const QString& mapName : parser.values(renderStitchOption)) {
+            Map* map = project.getMap(mapName);
+            if (!map || !headless.saveImage(headless.renderStitch(map), QString("Stitch_From_%1.png").arg(mapName)))
+                errors++;
+        }
+        if (parser.isSet(renderStitchOption))
+            headless.endPhase("render stitches");
+
+        for (const QString& pair : parser.values(renderTilesetsOption)) {
+            QStringList labels = pair.split(",");
+            if (labels.length() != 2) {
+                logError(QString("Expected a primary and secondary tileset separated by a comma, but found '%1'").arg(pair));
+                errors++;
+                continue;
+            }
+            QString filename = QString("%1_%2.png").arg(labels.at(0)).arg(labels.at(1));
+            if (!headless.saveImage(headless.renderTilesets(labels.at(0), labels.at(1)), filename))
+                errors++;
+        }
+        if (parser.isSet(renderTilesetsOption))
+            headless.endPhase("render tilesets");
+    }
+
+    if (parser.isSet(timingsOption))
+        headless.printTimings();
+    flushLog();
+    return errors ? 1 : 0;
+}
+
+void Headless::endPhase(const QString& name) {
+    timings.append(qMakePair(name, phaseTimer.restart()));
+}
+
+void Headless::printTimings() {
+    QTextStream out(stdout);
+    qint64 total = 0;
+    for (auto timing : timings) {
+        out << QString("%1 ms").arg(timing.second, 8) << "  " << timing.first << "\n";
+        // The data structures are read concurrently, so their own times overlap.
+        if (timing.first == "data structures") {
+            for (auto readTime : project->dataStructureReadTimes)
+                out << QString("%1 ms").arg(readTime.second, 8) << "    " << readTime.first << "\n";
+        }
+        total += timing.second;
+    }
+    out << QString("%1 ms").arg(total, 8) << "  total\n";
+}
+
+bool Headless::openProject(const QString& dir, const QString& baseGame) {
+    QDir projectDir(dir);
+    if (!projectDir.exists()) {
+        logError(QString("Project directory '%1' does not exist").arg(dir));
+        return false;
+    }
+    if (!baseGame.isEmpty() && !baseGameVersions.contains(baseGame)) {
+        logError(QString("Unknown base game '%1'. Expected one of: %2").arg(baseGame).arg(baseGameVersions.join(", ")));
+        return false;
+    }
+
+    // Loading a missing project config would create one and ask for the base game in a dialog.
+    // Headless runs shouldn't modify the project, so the config's defaults are only set up in memory.
+    QString root = projectDir.absolutePath();
+    projectConfig.setProjectDir(root);
+    if (QFile::exists(projectDir.filePath("porymap.project.cfg"))) {
+        projectConfig.load();
+    } else {
+        QString game = baseGame.isEmpty() ? projectDir.dirName().toLower() : baseGame;
+        if (!baseGameVersions.contains(game)) {
+            logError(QString("'%1' has no porymap.project.cfg. Use --base-game to choose the project's base game.").arg(root));
+            return false;
+        }
+        projectConfig.loadDefaults(game);
+    }
+    project->set_root(root);
+    return true;
+}
+
+bool Headless::loadProject(const QString& dir, const QString& baseGame) {
+    logInfo(QString("Opening project: '%1'").arg(dir));
+    if (!openProject(dir, baseGame))
+        return false;
+    endPhase("config");
+
+    if (!project->readDataStructures())
+        return false;
+    endPhase("data structures");
+
+    if (!project->readMapGroups())
+        return false;
+    endPhase("map groups");
+
+    if (project->getTilesetLabels().isEmpty())
+        return false;
+    endPhase("tileset labels");
+    return true;
+}
+
+int Headless::checkProject() {
+    QStringList problems;
+
+    // Tileset references are checked before any map is loaded, since loading replaces invalid tilesets with the defaults.
+    const QStringList primaryLabels = project->tilesetLabels.value("primary");
+    const QStringList secondaryLabels = project->tilesetLabels.value("secondary");
+    for (const QString& layoutId : project->mapLayoutsTable) {
+        MapLayout* layout = project->mapLayouts.value(layoutId);
+        if (!layout)
+            continue;
+        if (!primaryLabels.contains(layout->tileset_primary_label))
+            problems.append(QString("Layout '%1' has unknown primary tileset '%2'").arg(layoutId).arg(layout->tileset_primary_label));
+        if (!secondaryLabels.contains(layout->tileset_secondary_label))
+            problems.append(QString("Layout '%1' has unknown secondary tileset '%2'").arg(layoutId).arg(layout->tileset_secondary_label));
+    }
+
+    QSet<QString> checkedLayouts;
+    for (const QString& mapName : project->mapNames) {
+        QString layoutId = project->readMapLayoutId(mapName);
+        if (!project->mapLayouts.contains(layoutId)) {
+            problems.append(QString("Map '%1' has unknown layout '%2'").arg(mapName).arg(layoutId));
+            continue;
+        }
+        Map* map = project->getMap(mapName);
+        if (!map) {
+            problems.append(QString("Map '%1' could not be loaded").arg(mapName));
+            continue;
+        }
+        if (!checkedLayouts.contains(layoutId)) {
+            checkedLayouts.insert(layoutId);
+            problems.append(checkMetatileIds(map));
+        }
+        for (Event* event : map->getAllEvents()) {
+            if (event->x() < 0 || event->x() >= map->getWidth() || event->y() < 0 || event->y() >= map->getHeight()) {
+                problems.append(QString("Map '%1' has a %2 event at (%3, %4), outside of its %5x%6 area")
+                                    .arg(mapName)
+                                    .arg(event->get("event_type"))
+                                    .arg(event->x())
+                                    .arg(event->y())
+                                    .arg(map->getWidth())
+                                    .arg(map->getHeight()));
+            }
+        }
+        project->evictCaches(QStringList());
+    }
+    endPhase("check");
+
+    QTextStream out(stdout);
+    for (const QString& problem : problems) {
+        out << problem << "\n";
+    }
+    out << QString("Checked %1 maps and %2 layouts: %3 problem(s) found.\n")
+               .arg(project->mapNames.length())
+               .arg(project->mapLayoutsTable.length())
+               .arg(problems.length());
+    return problems.length();
+}
+
+QStringList Headless::checkMetatileIds(Map* map) {
+    MapLayout* layout = map->layout;
+    if (!layout->tileset_primary || !layout->tileset_secondary)
+        return QStringList();
+
+    int numPrimary = layout->tileset_primary->metatiles.length();
+    int numSecondary = layout->tileset_secondary->metatiles.length();
+    auto isValid = [=](int metatileId) {
+        if (metatileId < Project::getNumMetatilesPrimary())
+            return metatileId < numPrimary;
+        return metatileId - Project::getNumMetatilesPrimary() < numSecondary;
+    };
+
+    QStringList problems;
+    for (int i = 0; i < layout->blockdata.length(); i++) {
+        int metatileId = layout->blockdata.at(i).tile;
+        if (!isValid(metatileId)) {
+            problems.append(QString("Layout '%1' has invalid metatile id 0x%2 at (%3, %4)")
+                                .arg(layout->id)
+                                .arg(metatileId, 3, 16, QChar('0'))
+                                .arg(i % map->getWidth())
+                                .arg(i / map->getWidth()));
+        }
+    }
+    for (int i = 0; i < layout->border.length(); i++) {
+        int metatileId = layout->border.at(i).tile;
+        if (!isValid(metatileId)) {
+            problems.append(QString("Layout '%1' has invalid border metatile id 0x%2 at (%3, %4)")
+                                .arg(layout->id)
+                                .arg(metatileId, 3, 16, QChar('0'))
+                                .arg(i % map->getBorderWidth())
+                                .arg(i / map->getBorderWidth()));
+        }
+    }
+    return problems;
+}
+
+QImage Headless::renderMap(Map* map) {
+    QImage image(map->getWidth() * 16, map->getHeight() * 16, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    QRect blockRect(0, 0, map->getWidth(), map->getHeight());
+    if (showCollision) {
+        map->paintCollisionBlocks(&painter, blockRect, 1.0);
+    } else {
+        map->paintBlocks(&painter, blockRect);
+    }
+    painter.end();
+    return image;
+}
+
+// Lays out every map reachable through connections from startMap, like the map stitch image exporter.
+QImage Headless::renderStitch(Map* startMap) {
+    QList<QPair<QPoint, Map*>> stitchedMaps;
+    QList<QPair<QPoint, Map*>> unvisited;
+    QSet<QString> visited;
+    unvisited.append(qMakePair(QPoint(0, 0), startMap));
+    while (!unvisited.isEmpty()) {
+        QPair<QPoint, Map*> cur = unvisited.takeFirst();
+        if (visited.contains(cur.second->name))
+            continue;
+        visited.insert(cur.second->name);
+        stitchedMaps.append(cur);
+
+        for (MapConnection* connection : cur.second->connections) {
+            if (connection->direction == "dive" || connection->direction == "emerge")
+                continue;
+            Map* connectionMap = project->getMap(connection->map_name);
+            if (!connectionMap) {
+                logWarn(QString("Skipping connection from '%1' to unknown map '%2'").arg(cur.second->name).arg(connection->map_name));
+                continue;
+            }
+            QPoint pos = cur.first;
+            int offset = connection->offset.toInt(nullptr, 0);
+            if (connection->direction == "up") {
+                pos += QPoint(offset, -connectionMap->getHeight());
+            } else if (connection->direction == "down") {
+                pos += QPoint(offset, cur.second->getHeight());
+            } else if (connection->direction == "left") {
+                pos += QPoint(-connectionMap->getWidth(), offset);
+            } else if (connection->direction == "right") {
+                pos += QPoint(cur.second->getWidth(), offset);
+            }
+            unvisited.append(qMakePair(pos, connectionMap));
+        }
+    }
+
+    QRect bounds;
+    for (auto stitched : stitchedMaps) {
+        bounds |= QRect(stitched.first, QSize(stitched.second->getWidth(), stitched.second->getHeight()));
+    }
+    QImage image(bounds.width() * 16, bounds.height() * 16, QImage::Format_ARGB32_Premultiplied);
+    if (image.isNull()) {
+        logError(QString("Failed to allocate a %1x%2 image for the map stitch.").arg(bounds.width() * 16).arg(bounds.height() * 16));
+        return QImage();
+    }
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    for (auto stitched : stitchedMaps) {
+        Map* map = stitched.second;
+        QPoint origin = (stitched.first - bounds.topLeft()) * 16;
+        painter.save();
+        painter.translate(origin);
+        QRect blockRect(0, 0, map->getWidth(), map->getHeight());
+        if (showCollision) {
+            map->paintCollisionBlocks(&painter, blockRect, 1.0);
+        } else {
+            map->paintBlocks(&painter, blockRect);
+        }
+        painter.restore();
+    }
+    painter.end();
+    return image;
+}
+
+QImage Headless::renderTilesets(const QString& primaryLabel, const QString& secondaryLabel) {
+    Tileset* primaryTileset = project->getTileset(primaryLabel);
+    Tileset* secondaryTileset = project->getTileset(secondaryLabel);
+    if (!primaryTileset || !secondaryTileset) {
+        logError(QString("Failed to load tilesets '%1' and '%2'").arg(primaryLabel).arg(secondaryLabel));
+        return QImage();
+    }
+
+    int primaryLength = primaryTileset->metatiles.length();
+    int length = primaryLength + secondaryTileset->metatiles.length();
+    int height = (length + numMetatilesWide - 1) / numMetatilesWide;
+    QImage image(numMetatilesWide * 16, height * 16, QImage::Format_RGBA8888);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    for (int i = 0; i < length; i++) {
+        int metatileId = i;
+        if (i >= primaryLength)
+            metatileId += Project::getNumMetatilesPrimary() - primaryLength;
+        QImage metatileImage = getMetatileImage(metatileId, primaryTileset, secondaryTileset, QList<int>(), QList<float>());
+        painter.drawImage(QPoint((i % numMetatilesWide) * 16, (i / numMetatilesWide) * 16), metatileImage);
+    }
+    painter.end();
+    return image;
+}
+
+bool Headless::saveImage(const QImage& image, const QString& filename) {
+    if (image.isNull())
+        return false;
+    QDir dir(outputDir);
+    if (!dir.exists() && !dir.mkpath(".")) {
+        logError(QString("Could not create output directory '%1'").arg(outputDir));
+        return false;
+    }
+    QString path = dir.filePath(filename);
+    if (!image.save(path, "PNG")) {
+        logError(QString("Could not save image '%1'").arg(path));
+        return false;
+    }
+    logInfo(QString("Saved '%1'").arg(path));
+    return true;
+}
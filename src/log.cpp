@@ -1,6 +1,10 @@
 #include "log.h"
 #include <QDateTime>
 #include <QDir>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThread>
+#include <QVector>
 #include <QStandardPaths>
 #include <QSysInfo>
 
@@ -18,6 +22,85 @@
 #define CLEAR_COLOR "\033[0m"
 #endif
 
+// Messages are queued and written to the console and log file in batches by a background thread,
+// so logging never waits on file I/O. Errors and shutdown wait for the queue to be written.
+static const int maxPendingLines = 10000;
+static const int historySize = 5000;
+
+struct LogLine {
+    QString text;
+    LogType type;
+};
+
+// Project data may be read on worker threads, which can log at the same time.
+static QMutex logMutex;
+static QWaitCondition logWorkAvailable;
+static QWaitCondition logDrained;
+static QVector<LogLine> pendingLines;
+static int droppedLines = 0;
+static bool writingLines = false;
+static bool stoppingWriter = false;
+
+// The most recent lines, for the in-app log viewer.
+static QVector<QString> history(historySize);
+static quint64 historyCount = 0;
+
+// Identical consecutive messages are written once, followed by the number of repeats.
+static QString lastMessage;
+static LogType lastType = LogType::LOG_INFO;
+static int repeatCount = 0;
+
+static QString mostRecentError;
+
+static void writeLines(const QVector<LogLine>& lines);
+
+class LogWriter : public QThread {
+protected:
+    void run() override {
+        QMutexLocker locker(&logMutex);
+        while (true) {
+            if (pendingLines.isEmpty() && !stoppingWriter)
+                logWorkAvailable.wait(&logMutex, 200);
+            if (pendingLines.isEmpty()) {
+                if (stoppingWriter)
+                    break;
+                continue;
+            }
+
+            QVector<LogLine> batch;
+            batch.swap(pendingLines);
+            if (droppedLines) {
+                batch.prepend({ QString("%1 log messages were dropped.").arg(droppedLines), LogType::LOG_WARN });
+                droppedLines = 0;
+            }
+            writingLines = true;
+            locker.unlock();
+            writeLines(batch);
+            locker.relock();
+            writingLines = false;
+            logDrained.wakeAll();
+        }
+        logDrained.wakeAll();
+    }
+};
+
+static LogWriter* logWriter = nullptr;
+
+static void stopLogWriter() {
+    flushLog();
+    {
+        QMutexLocker locker(&logMutex);
+        if (!logWriter)
+            return;
+        stoppingWriter = true;
+        logWorkAvailable.wakeOne();
+    }
+    logWriter->wait();
+    QMutexLocker locker(&logMutex);
+    delete logWriter;
+    logWriter = nullptr;
+}
+
 void logInfo(QString message) {
     log(message, LogType::LOG_INFO);
 }
@@ -26,11 +109,13 @@ void logWarn(QString message) {
     log(message, LogType::LOG_WARN);
 }
 
-static QString mostRecentError;
-
 void logError(QString message) {
-    mostRecentError = message;
+    {
+        QMutexLocker locker(&logMutex);
+        mostRecentError = message;
+    }
     log(message, LogType::LOG_ERROR);
+    flushLog();
 }
 
 QString colorizeMessage(QString message, LogType type) {
@@ -49,7 +134,7 @@ QString colorizeMessage(QString message, LogType type) {
     return colorized;
 }
 
-void log(QString message, LogType type) {
+static QString formatLine(const QString& message, LogType type) {
     QString now = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
     QString typeString = "";
     switch (type) {
@@ -63,14 +148,87 @@ void log(QString message, LogType type) {
         typeString = "[ERROR]";
         break;
     }
+    return QString("%1 %2 %3").arg(now).arg(typeString).arg(message);
+}
 
-    message = QString("%1 %2 %3").arg(now).arg(typeString).arg(message);
-
-    qDebug().noquote() << colorizeMessage(message, type);
+static void writeLines(const QVector<LogLine>& lines) {
+    for (const LogLine& line : lines) {
+        qDebug().noquote() << colorizeMessage(line.text, line.type);
+    }
     QFile outFile(getLogPath());
-    outFile.open(QIODevice::WriteOnly | QIODevice::Append);
+    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Append))
+        return;
     QTextStream ts(&outFile);
-    ts << message << Qt::endl;
+    for (const LogLine& line : lines) {
+        ts << line.text << '\n';
+    }
+}
+
+// Must be called with logMutex locked.
+static void queueLine(const QString& message, LogType type) {
+    LogLine line = { formatLine(message, type), type };
+    history[historyCount % historySize] = line.text;
+    historyCount++;
+
+    if (!logWriter) {
+        // Without an application to shut the writer down (or after it has), write directly.
+        writeLines({ line });
+        return;
+    }
+    if (pendingLines.length() >= maxPendingLines) {
+        pendingLines.removeFirst();
+        droppedLines++;
+    }
+    pendingLines.append(line);
+}
+
+// Must be called with logMutex locked.
+static void queueRepeatCount() {
+    if (repeatCount > 0) {
+        queueLine(QString("Previous message repeated %1 more time(s).").arg(repeatCount), lastType);
+        repeatCount = 0;
+    }
+}
+
+void log(QString message, LogType type) {
+    QMutexLocker locker(&logMutex);
+    if (message == lastMessage && type == lastType) {
+        repeatCount++;
+        return;
+    }
+    queueRepeatCount();
+    lastMessage = message;
+    lastType = type;
+
+    if (!logWriter && !stoppingWriter && QCoreApplication::instance()) {
+        logWriter = new LogWriter;
+        logWriter->start(QThread::LowPriority);
+        qAddPostRoutine(stopLogWriter);
+    }
+    queueLine(message, type);
+}
+
+void flushLog() {
+    QMutexLocker locker(&logMutex);
+    queueRepeatCount();
+    lastMessage = QString();
+    if (!logWriter)
+        return;
+    logWorkAvailable.wakeOne();
+    while (!pendingLines.isEmpty() || writingLines) {
+        logDrained.wait(&logMutex);
+    }
+}
+
+QStringList getRecentLogLines(quint64* since) {
+    QMutexLocker locker(&logMutex);
+    quint64 oldest = historyCount > static_cast<quint64>(historySize) ? historyCount - historySize : 0;
+    QStringList lines;
+    for (quint64 i = qMax(*since, oldest); i < historyCount; i++) {
+        lines.append(history.at(static_cast<int>(i % historySize)));
+    }
+    *since = historyCount;
+    return lines;
 }
 
 QString getLogPath() {
@@ -82,10 +240,12 @@ QString getLogPath() {
 }
 
 QString getMostRecentError() {
+    QMutexLocker locker(&logMutex);
     return mostRecentError;
 }
 
 bool cleanupLargeLog() {
+    flushLog();
     QFile logFile(getLogPath());
     if (logFile.size() < 20000000)
         return false;
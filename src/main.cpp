@@ -1,7 +1,16 @@
 #include "mainwindow.h"
+#include "headless.h"
 #include <QApplication>
 
 int main(int argc, char* argv[]) {
+    if (Headless::isRequested(argc, argv)) {
+        // Headless runs don't need a display.
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        QApplication a(argc, argv);
+        return Headless::run(a.arguments());
+    }
+
     QApplication a(argc, argv);
     a.setStyle("fusion");
     MainWindow w(nullptr);
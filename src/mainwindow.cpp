@@ -34,6 +34,7 @@
 #include <QTransform>
 #include <QSignalBlocker>
 #include <QSet>
+#include <QProgressDialog>
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent),
@@ -62,6 +63,7 @@ MainWindow::MainWindow(QWidget* parent)
 }
 
 MainWindow::~MainWindow() {
+    clearEventFramePool();
     delete label_MapRulerStatus;
     delete ui;
 }
@@ -216,6 +218,10 @@ void MainWindow::initExtraSignals() {
     label_MapRulerStatus->setAlignment(Qt::AlignCenter);
     label_MapRulerStatus->setTextFormat(Qt::PlainText);
     label_MapRulerStatus->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    // How much memory the loaded maps and tilesets use, next to the cache budget
+    label_CacheUsage = new QLabel(this);
+    ui->statusBar->addPermanentWidget(label_CacheUsage);
 }
 
 void MainWindow::initEditor() {
@@ -465,6 +471,8 @@ bool MainWindow::openProject(QString dir) {
     this->setProjectSpecificUIVisibility();
 
     Scripting::init(this);
+    // The event frames use the project's list models, and the project config decides which fields they have.
+    clearEventFramePool();
     bool already_open = isProjectOpen() && (editor->project->root == dir);
     if (!already_open) {
         editor->closeProject();
@@ -480,6 +488,7 @@ bool MainWindow::openProject(QString dir) {
         editor->project->fileWatcher.removePaths(editor->project->fileWatcher.files());
         editor->project->clearMapCache();
         editor->project->clearTilesetCache();
+        editor->project->clearEventGraphics();
         success = loadDataStructures() && populateMapList() && setMap(open_map, true);
     }
 
@@ -605,9 +614,33 @@ bool MainWindow::setMap(QString map_name, bool scrollTreeView) {
 
     Scripting::cb_MapOpened(map_name);
     updateTilesetEditor();
+    trimProjectCaches();
     return true;
 }
 
+// Unloads maps and tilesets that haven't been used recently if the caches are over budget.
+// The open map, the maps it connects to and the map being exported are kept.
+void MainWindow::trimProjectCaches() {
+    Project* project = editor ? editor->project : nullptr;
+    if (!project)
+        return;
+
+    QStringList pinnedMaps;
+    if (editor->map) {
+        pinnedMaps.append(editor->map->name);
+        for (MapConnection* connection : editor->map->connections) {
+            pinnedMaps.append(connection->map_name);
+        }
+    }
+    if (mapImageExporter && mapImageExporter->getMap())
+        pinnedMaps.append(mapImageExporter->getMap()->name);
+    project->evictCaches(pinnedMaps);
+
+    label_CacheUsage->setText(
+        QString("Cache: %1 / %2 MB").arg(project->getCacheMemoryUsage() / (1024 * 1024)).arg(porymapConfig.getCacheBudgetMB()));
+    label_CacheUsage->setToolTip(QString("%1 map(s) and %2 tileset(s) loaded").arg(project->mapCache.size()).arg(project->tilesetCache.size()));
+}
+
 void MainWindow::redrawMapScene() {
     if (!editor->displayMap())
         return;
@@ -821,12 +854,18 @@ void MainWindow::on_spinBox_FloorNumber_valueChanged(int offset) {
 
 bool MainWindow::loadDataStructures() {
     Project* project = editor->project;
-    bool success = project->readMapLayouts() && project->readRegionMapSections() && project->readItemNames() && project->readFlagNames()
-        && project->readVarNames() && project->readMovementTypes() && project->readInitialFacingDirections() && project->readMapTypes()
-        && project->readMapBattleScenes() && project->readWeatherNames() && project->readCoordEventWeatherNames() && project->readSecretBaseIds()
-        && project->readBgEventFacingDirections() && project->readTrainerTypes() && project->readMetatileBehaviors() && project->readTilesetProperties()
-        && project->readMaxMapDataSize() && project->readHealLocations() && project->readMiscellaneousConstants() && project->readSpeciesIconPaths()
-        && project->readWildMonData();
+
+    QProgressDialog progress("Reading project data...", "Cancel", 0, 0, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    connect(project, &Project::dataStructuresReadProgress, &progress, [&progress](int finished, int total) {
+        progress.setMaximum(total);
+        progress.setValue(finished);
+    });
+    connect(&progress, &QProgressDialog::canceled, project, &Project::cancelReadingDataStructures);
+
+    bool success = project->readDataStructures();
+    progress.close();
 
     return success && loadProjectCombos();
 }
@@ -915,6 +954,7 @@ void MainWindow::sortMapList() {
         }
         break;
     case MapSortOrder::Area: {
+        project->updateMapHeaderIndex();
         QMap<QString, int> mapsecToGroupNum;
         for (int i = 0; i < project->mapSectionNameToValue.size(); i++) {
             QString mapsec_name = project->mapSectionValueToName.value(i);
@@ -944,6 +984,7 @@ void MainWindow::sortMapList() {
         break;
     }
     case MapSortOrder::Layout: {
+        project->updateMapHeaderIndex();
         QMap<QString, int> layoutIndices;
         for (int i = 0; i < project->mapLayoutsTable.length(); i++) {
             QString layoutId = project->mapLayoutsTable.value(i);
@@ -1069,7 +1110,7 @@ void MainWindow::onNewMapCreated() {
 
     if (newMap->isFlyable == "TRUE") {
         addNewEvent(EventType::HealLocation);
-        editor->project->saveHealLocationStruct(newMap);
+        // Saving the map also saves its heal location.
         editor->save(); // required
     }
 
@@ -1556,350 +1597,20 @@ void MainWindow::updateSelectedObjects() {
         }
     }
 
-    for (auto* button : openScriptButtons)
-        delete button;
-    openScriptButtons.clear();
+    releaseEventFrames();
 
-    QMap<QString, int> event_obj_gfx_constants = editor->project->getEventObjGfxConstants();
+    // Frames are unbound, so the script labels can be replaced without clearing their combo boxes' text.
+    QStringList scriptLabels = editor->map ? editor->map->eventScriptLabels() : QStringList();
+    if (!scriptLabelsModel)
+        scriptLabelsModel = new QStringListModel(this);
+    if (scriptLabelsModel->stringList() != scriptLabels)
+        scriptLabelsModel->setStringList(scriptLabels);
 
     QList<EventPropertiesFrame*> frames;
-
-    bool inConnectionEnabled = projectConfig.getObjectEventInConnectionEnabled();
-    bool quantityEnabled = projectConfig.getHiddenItemQuantityEnabled();
-    bool underfootEnabled = projectConfig.getHiddenItemRequiresItemfinderEnabled();
-    bool respawnDataEnabled = projectConfig.getHealLocationRespawnDataEnabled();
     for (DraggablePixmapItem* item : events) {
-        EventPropertiesFrame* frame = new EventPropertiesFrame(item->event);
-        //        frame->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
-
-        NoScrollSpinBox* x = frame->ui->spinBox_x;
-        NoScrollSpinBox* y = frame->ui->spinBox_y;
-        NoScrollSpinBox* z = frame->ui->spinBox_z;
-
-        x->setValue(item->event->x());
-        connect(x, QOverload<int>::of(&QSpinBox::valueChanged), [this, item, x](int value) {
-            int delta = value - item->event->x();
-            if (delta)
-                editor->map->editHistory.push(new EventMove(QList<Event*>() << item->event, delta, 0, x->getActionId()));
-        });
-        connect(item, &DraggablePixmapItem::xChanged, x, &NoScrollSpinBox::setValue);
-
-        y->setValue(item->event->y());
-        connect(y, QOverload<int>::of(&QSpinBox::valueChanged), [this, item, y](int value) {
-            int delta = value - item->event->y();
-            if (delta)
-                editor->map->editHistory.push(new EventMove(QList<Event*>() << item->event, 0, delta, y->getActionId()));
-        });
-        connect(item, &DraggablePixmapItem::yChanged, y, &NoScrollSpinBox::setValue);
-
-        z->setValue(item->event->elevation());
-        connect(z, &NoScrollSpinBox::textChanged, item, &DraggablePixmapItem::set_elevation);
-        connect(item, &DraggablePixmapItem::elevationChanged, z, &NoScrollSpinBox::setValue);
-
-        QString event_type = item->event->get("event_type");
-        QString event_group_type = item->event->get("event_group_type");
-        QString map_name = item->event->get("map_name");
-        int event_offs;
-        if (event_type == EventType::Warp) {
-            event_offs = 0;
-        } else {
-            event_offs = 1;
-        }
-        frame->ui->label_name->setText(QString("%1 Id").arg(event_type));
-
-        if (events.count() == 1) {
-            frame->ui->spinBox_index->setValue(editor->project->getMap(map_name)->events.value(event_group_type).indexOf(item->event) + event_offs);
-            frame->ui->spinBox_index->setMinimum(event_offs);
-            frame->ui->spinBox_index->setMaximum(editor->project->getMap(map_name)->events.value(event_group_type).length() + event_offs - 1);
-            connect(frame->ui->spinBox_index, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::selectedEventIndexChanged);
-        } else {
-            frame->ui->spinBox_index->setVisible(false);
-        }
-
-        frame->ui->label_spritePixmap->setPixmap(item->event->pixmap);
-        connect(item, &DraggablePixmapItem::spriteChanged, frame->ui->label_spritePixmap, &QLabel::setPixmap);
-
-        frame->ui->sprite->setVisible(false);
-
-        QMap<QString, QString> field_labels;
-        field_labels["script_label"] = "Script";
-        field_labels["event_flag"] = "Event Flag";
-        field_labels["movement_type"] = "Movement";
-        field_labels["radius_x"] = "Movement Radius X";
-        field_labels["radius_y"] = "Movement Radius Y";
-        field_labels["trainer_type"] = "Trainer Type";
-        field_labels["sight_radius_tree_id"] = "Sight Radius / Berry Tree ID";
-        field_labels["in_connection"] = "In Connection";
-        field_labels["destination_warp"] = "Destination Warp";
-        field_labels["destination_map_name"] = "Destination Map";
-        field_labels["script_var"] = "Var";
-        field_labels["script_var_value"] = "Var Value";
-        field_labels["player_facing_direction"] = "Player Facing Direction";
-        field_labels["item"] = "Item";
-        field_labels["quantity"] = "Quantity";
-        field_labels["underfoot"] = "Requires Itemfinder";
-        field_labels["weather"] = "Weather";
-        field_labels["flag"] = "Flag";
-        field_labels["secret_base_id"] = "Secret Base Id";
-        field_labels["respawn_map"] = "Respawn Map";
-        field_labels["respawn_npc"] = "Respawn NPC";
-
-        QStringList fields;
-
-        if (event_type == EventType::Object) {
-
-            frame->ui->sprite->setVisible(true);
-            frame->ui->comboBox_sprite->addItems(event_obj_gfx_constants.keys());
-            frame->ui->comboBox_sprite->setCurrentIndex(frame->ui->comboBox_sprite->findText(item->event->get("sprite")));
-            connect(frame->ui->comboBox_sprite, &QComboBox::currentTextChanged, item, &DraggablePixmapItem::set_sprite);
-
-            /*
-            frame->ui->script->setVisible(true);
-            frame->ui->comboBox_script->addItem(item->event->get("script_label"));
-            frame->ui->comboBox_script->setCurrentText(item->event->get("script_label"));
-            //item->bind(frame->ui->comboBox_script, "script_label");
-            connect(frame->ui->comboBox_script, SIGNAL(activated(QString)), item, SLOT(set_script(QString)));
-            //connect(frame->ui->comboBox_script, static_cast<void (QComboBox::*)(const QString&)>(&QComboBox::activated), item, [item](QString script_label){
-            item->event->put("script_label", script_label); });
-            //connect(item, SIGNAL(scriptChanged(QString)), frame->ui->comboBox_script, SLOT(setValue(QString)));
-            */
-
-            fields << "movement_type";
-            fields << "radius_x";
-            fields << "radius_y";
-            fields << "script_label";
-            fields << "event_flag";
-            fields << "trainer_type";
-            fields << "sight_radius_tree_id";
-            if (inConnectionEnabled)
-                fields << "in_connection";
-        } else if (event_type == EventType::Warp) {
-            fields << "destination_map_name";
-            fields << "destination_warp";
-        } else if (event_type == EventType::Trigger) {
-            fields << "script_label";
-            fields << "script_var";
-            fields << "script_var_value";
-        } else if (event_type == EventType::WeatherTrigger) {
-            fields << "weather";
-        } else if (event_type == EventType::Sign) {
-            fields << "player_facing_direction";
-            fields << "script_label";
-        } else if (event_type == EventType::HiddenItem) {
-            fields << "item";
-            fields << "flag";
-            if (quantityEnabled)
-                fields << "quantity";
-            if (underfootEnabled)
-                fields << "underfoot";
-        } else if (event_type == EventType::SecretBase) {
-            fields << "secret_base_id";
-        } else if (event_type == EventType::HealLocation) {
-            // Hide elevation so users don't get impression that editing it is meaningful.
-            frame->ui->spinBox_z->setVisible(false);
-            frame->ui->label_z->setVisible(false);
-            if (respawnDataEnabled) {
-                fields << "respawn_map";
-                fields << "respawn_npc";
-            }
-        }
-
-        // Some keys shouldn't use a combobox
-        QStringList spinKeys = { "quantity", "respawn_npc" };
-        QStringList checkKeys = { "underfoot", "in_connection" };
-        for (QString key : fields) {
-            QString value = item->event->get(key);
-            QWidget* widget = new QWidget(frame);
-            QFormLayout* fl = new QFormLayout(widget);
-            fl->setContentsMargins(9, 0, 9, 0);
-            fl->setRowWrapPolicy(QFormLayout::WrapLongRows);
-
-            NoScrollSpinBox* spin;
-            NoScrollComboBox* combo;
-            QCheckBox* check;
-
-            if (spinKeys.contains(key)) {
-                spin = new NoScrollSpinBox(widget);
-            } else if (checkKeys.contains(key)) {
-                check = new QCheckBox(widget);
-            } else {
-                combo = new NoScrollComboBox(widget);
-                combo->setEditable(true);
-            }
-
-            if (key == "destination_map_name") {
-                if (!editor->project->mapNames.contains(value)) {
-                    combo->addItem(value);
-                }
-                combo->addItems(editor->project->mapNames);
-                combo->setCurrentIndex(combo->findText(value));
-                combo->setToolTip("The destination map name of the warp.");
-            } else if (key == "destination_warp") {
-                combo->setToolTip("The warp id on the destination map.");
-            } else if (key == "item") {
-                if (!editor->project->itemNames.contains(value)) {
-                    combo->addItem(value);
-                }
-                combo->addItems(editor->project->itemNames);
-                combo->setCurrentIndex(combo->findText(value));
-            } else if (key == "quantity") {
-                spin->setToolTip("The number of items received when the hidden item is picked up.");
-                // Min 1 not needed. 0 is treated as a valid quantity and works as expected in-game.
-                spin->setMaximum(127);
-            } else if (key == "underfoot") {
-                check->setToolTip("If checked, hidden item can only be picked up using the Itemfinder");
-            } else if (key == "flag" || key == "event_flag") {
-                if (!editor->project->flagNames.contains(value)) {
-                    combo->addItem(value);
-                }
-                combo->addItems(editor->project->flagNames);
-                combo->setCurrentIndex(combo->findText(value));
-                if (key == "flag")
-                    combo->setToolTip("The flag which is set when the hidden item is picked up.");
-                else if (key == "event_flag")
-                    combo->setToolTip("The flag which hides the object when set.");
-            } else if (key == "script_var") {
-                if (!editor->project->varNames.contains(value)) {
-                    combo->addItem(value);
-                }
-                combo->addItems(editor->project->varNames);
-                combo->setCurrentIndex(combo->findText(value));
-                combo->setToolTip("The variable by which the script is triggered.\n"
-                                  "The script is triggered when this variable's value matches 'Var Value'.");
-            } else if (key == "script_var_value") {
-                combo->setToolTip("The variable's value which triggers the script.");
-            } else if (key == "movement_type") {
-                if (!editor->project->movementTypes.contains(value)) {
-                    combo->addItem(value);
-                }
-                connect(combo, static_cast<void (QComboBox::*)(const QString&)>(&QComboBox::currentTextChanged), this, [this, item](QString value) {
-                    item->event->setFrameFromMovement(editor->project->facingDirections.value(value));
-                    item->updatePixmap();
-                });
-                combo->addItems(editor->project->movementTypes);
-                combo->setCurrentIndex(combo->findText(value));
-                combo->setToolTip("The object's natural movement behavior when\n"
-                                  "the player is not interacting with it.");
-            } else if (key == "weather") {
-                if (!editor->project->coordEventWeatherNames.contains(value)) {
-                    combo->addItem(value);
-                }
-                combo->addItems(editor->project->coordEventWeatherNames);
-                combo->setCurrentIndex(combo->findText(value));
-                combo->setToolTip("The weather that starts when the player steps on this spot.");
-            } else if (key == "secret_base_id") {
-                if (!editor->project->secretBaseIds.contains(value)) {
-                    combo->addItem(value);
-                }
-                combo->addItems(editor->project->secretBaseIds);
-                combo->setCurrentIndex(combo->findText(value));
-                combo->setToolTip("The secret base id which is inside this secret\n"
-                                  "base entrance. Secret base ids are meant to be\n"
-                                  "unique to each and every secret base entrance.");
-            } else if (key == "player_facing_direction") {
-                if (!editor->project->bgEventFacingDirections.contains(value)) {
-                    combo->addItem(value);
-                }
-                combo->addItems(editor->project->bgEventFacingDirections);
-                combo->setCurrentIndex(combo->findText(value));
-                combo->setToolTip("The direction which the player must be facing\n"
-                                  "to be able to interact with this event.");
-            } else if (key == "radius_x") {
-                combo->setToolTip("The maximum number of metatiles this object\n"
-                                  "is allowed to move left or right during its\n"
-                                  "normal movement behavior actions.");
-                combo->setMinimumContentsLength(4);
-            } else if (key == "radius_y") {
-                combo->setToolTip("The maximum number of metatiles this object\n"
-                                  "is allowed to move up or down during its\n"
-                                  "normal movement behavior actions.");
-                combo->setMinimumContentsLength(4);
-            } else if (key == "script_label") {
-                combo->addItems(editor->map->eventScriptLabels());
-                combo->setToolTip("The script which is executed with this event.");
-            } else if (key == "trainer_type") {
-                combo->addItems(editor->project->trainerTypes);
-                combo->setCurrentIndex(combo->findText(value));
-                combo->setToolTip("The trainer type of this object event.\n"
-                                  "If it is not a trainer, use NONE. SEE ALL DIRECTIONS\n"
-                                  "should only be used with a sight radius of 1.");
-            } else if (key == "sight_radius_tree_id") {
-                combo->setToolTip("The maximum sight range of a trainer,\n"
-                                  "OR the unique id of the berry tree.");
-                combo->setMinimumContentsLength(4);
-            } else if (key == "in_connection") {
-                check->setToolTip("Check if object is positioned in the connection to another map.");
-            } else if (key == "respawn_map") {
-                if (!editor->project->mapNames.contains(value)) {
-                    combo->addItem(value);
-                }
-                combo->addItems(editor->project->mapNames);
-                combo->setToolTip("The map where the player will respawn after whiteout.");
-            } else if (key == "respawn_npc") {
-                spin->setToolTip("event_object ID of the NPC the player interacts with\n"
-                                 "upon respawning after whiteout.");
-                spin->setMinimum(1);
-                spin->setMaximum(126);
-            } else {
-                combo->addItem(value);
-            }
-
-            // Keys using spin boxes
-            if (spinKeys.contains(key)) {
-                spin->setValue(value.toInt());
-
-                fl->addRow(new QLabel(field_labels[key], widget), spin);
-                widget->setLayout(fl);
-                frame->layout()->addWidget(widget);
-
-                connect(spin, QOverload<int>::of(&NoScrollSpinBox::valueChanged), [item, key](int value) { item->event->put(key, value); });
-                // Keys using check boxes
-            } else if (checkKeys.contains(key)) {
-                check->setChecked(value.toInt());
-
-                fl->addRow(new QLabel(field_labels[key], widget), check);
-                widget->setLayout(fl);
-                frame->layout()->addWidget(widget);
-
-                connect(check, &QCheckBox::stateChanged, [item, key](int state) {
-                    switch (state) {
-                    case Qt::Checked:
-                        item->event->put(key, true);
-                        break;
-                    case Qt::Unchecked:
-                        item->event->put(key, false);
-                        break;
-                    }
-                });
-                // Keys using combo boxes
-            } else {
-                combo->setCurrentText(value);
-
-                if (key == "script_label") {
-                    // Add button next to combo which opens combo's current script.
-                    auto* hl = new QHBoxLayout();
-                    hl->setSpacing(3);
-                    auto* openScriptButton = new QToolButton(widget);
-                    openScriptButtons << openScriptButton;
-                    openScriptButton->setFixedSize(combo->height(), combo->height());
-                    openScriptButton->setIcon(QFileIconProvider().icon(QFileIconProvider::File));
-                    openScriptButton->setToolTip("Go to this script definition in text editor.");
-                    connect(openScriptButton, &QToolButton::clicked, [this, combo]() { this->editor->openScript(combo->currentText()); });
-                    hl->addWidget(combo);
-                    hl->addWidget(openScriptButton);
-                    fl->addRow(new QLabel(field_labels[key], widget), hl);
-                    if (porymapConfig.getTextEditorGotoLine().isEmpty())
-                        openScriptButton->hide();
-                } else {
-                    fl->addRow(new QLabel(field_labels[key], widget), combo);
-                }
-
-                widget->setLayout(fl);
-                frame->layout()->addWidget(widget);
-
-                item->bind(combo, key);
-            }
-        }
+        EventPropertiesFrame* frame = takeEventFrame(item->event->get("event_type"));
+        bindEventFrame(frame, item, events.count() == 1);
+        boundEventFrames.append(frame);
         frames.append(frame);
     }
 
@@ -1958,6 +1669,7 @@ void MainWindow::updateSelectedObjects() {
 
         for (EventPropertiesFrame* frame : frames) {
             layout->addWidget(frame);
+            frame->show();
         }
 
         layout->addStretch(1);
@@ -1974,6 +1686,353 @@ void MainWindow::updateSelectedObjects() {
     }
 }
 
+EventPropertiesFrame* MainWindow::takeEventFrame(const QString& eventType) {
+    QList<EventPropertiesFrame*>& pool = eventFramePool[eventType];
+    if (!pool.isEmpty())
+        return pool.takeLast();
+    return createEventFrame(eventType);
+}
+
+// Builds the widgets for an event type's fields. Values and connections for a specific event are set by bindEventFrame.
+EventPropertiesFrame* MainWindow::createEventFrame(const QString& event_type) {
+    Project* project = editor->project;
+    EventPropertiesFrame* frame = new EventPropertiesFrame(event_type);
+    //        frame->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+
+    frame->ui->label_name->setText(QString("%1 Id").arg(event_type));
+    frame->ui->sprite->setVisible(false);
+
+    QMap<QString, QString> field_labels;
+    field_labels["script_label"] = "Script";
+    field_labels["event_flag"] = "Event Flag";
+    field_labels["movement_type"] = "Movement";
+    field_labels["radius_x"] = "Movement Radius X";
+    field_labels["radius_y"] = "Movement Radius Y";
+    field_labels["trainer_type"] = "Trainer Type";
+    field_labels["sight_radius_tree_id"] = "Sight Radius / Berry Tree ID";
+    field_labels["in_connection"] = "In Connection";
+    field_labels["destination_warp"] = "Destination Warp";
+    field_labels["destination_map_name"] = "Destination Map";
+    field_labels["script_var"] = "Var";
+    field_labels["script_var_value"] = "Var Value";
+    field_labels["player_facing_direction"] = "Player Facing Direction";
+    field_labels["item"] = "Item";
+    field_labels["quantity"] = "Quantity";
+    field_labels["underfoot"] = "Requires Itemfinder";
+    field_labels["weather"] = "Weather";
+    field_labels["flag"] = "Flag";
+    field_labels["secret_base_id"] = "Secret Base Id";
+    field_labels["respawn_map"] = "Respawn Map";
+    field_labels["respawn_npc"] = "Respawn NPC";
+
+    QStringList fields;
+
+    if (event_type == EventType::Object) {
+        frame->ui->sprite->setVisible(true);
+        frame->ui->comboBox_sprite->setModel(project->getListModel("object_event_graphics"));
+        frame->ui->comboBox_sprite->setInsertPolicy(QComboBox::NoInsert);
+
+        fields << "movement_type";
+        fields << "radius_x";
+        fields << "radius_y";
+        fields << "script_label";
+        fields << "event_flag";
+        fields << "trainer_type";
+        fields << "sight_radius_tree_id";
+        if (projectConfig.getObjectEventInConnectionEnabled())
+            fields << "in_connection";
+    } else if (event_type == EventType::Warp) {
+        fields << "destination_map_name";
+        fields << "destination_warp";
+    } else if (event_type == EventType::Trigger) {
+        fields << "script_label";
+        fields << "script_var";
+        fields << "script_var_value";
+    } else if (event_type == EventType::WeatherTrigger) {
+        fields << "weather";
+    } else if (event_type == EventType::Sign) {
+        fields << "player_facing_direction";
+        fields << "script_label";
+    } else if (event_type == EventType::HiddenItem) {
+        fields << "item";
+        fields << "flag";
+        if (projectConfig.getHiddenItemQuantityEnabled())
+            fields << "quantity";
+        if (projectConfig.getHiddenItemRequiresItemfinderEnabled())
+            fields << "underfoot";
+    } else if (event_type == EventType::SecretBase) {
+        fields << "secret_base_id";
+    } else if (event_type == EventType::HealLocation) {
+        // Hide elevation so users don't get impression that editing it is meaningful.
+        frame->ui->spinBox_z->setVisible(false);
+        frame->ui->label_z->setVisible(false);
+        if (projectConfig.getHealLocationRespawnDataEnabled()) {
+            fields << "respawn_map";
+            fields << "respawn_npc";
+        }
+    }
+
+    // Some keys shouldn't use a combobox
+    QStringList spinKeys = { "quantity", "respawn_npc" };
+    QStringList checkKeys = { "underfoot", "in_connection" };
+    for (QString key : fields) {
+        QWidget* widget = new QWidget(frame);
+        QFormLayout* fl = new QFormLayout(widget);
+        fl->setContentsMargins(9, 0, 9, 0);
+        fl->setRowWrapPolicy(QFormLayout::WrapLongRows);
+
+        NoScrollSpinBox* spin;
+        NoScrollComboBox* combo;
+        QCheckBox* check;
+        QAbstractItemModel* listModel = nullptr;
+
+        if (spinKeys.contains(key)) {
+            spin = new NoScrollSpinBox(widget);
+            frame->fields.insert(key, spin);
+        } else if (checkKeys.contains(key)) {
+            check = new QCheckBox(widget);
+            frame->fields.insert(key, check);
+        } else {
+            combo = new NoScrollComboBox(widget);
+            combo->setEditable(true);
+            frame->fields.insert(key, combo);
+        }
+
+        if (key == "destination_map_name") {
+            listModel = project->getListModel("maps");
+            combo->setToolTip("The destination map name of the warp.");
+        } else if (key == "destination_warp") {
+            combo->setToolTip("The warp id on the destination map.");
+        } else if (key == "item") {
+            listModel = project->getListModel("items");
+        } else if (key == "quantity") {
+            spin->setToolTip("The number of items received when the hidden item is picked up.");
+            // Min 1 not needed. 0 is treated as a valid quantity and works as expected in-game.
+            spin->setMaximum(127);
+        } else if (key == "underfoot") {
+            check->setToolTip("If checked, hidden item can only be picked up using the Itemfinder");
+        } else if (key == "flag" || key == "event_flag") {
+            listModel = project->getListModel("flags");
+            if (key == "flag")
+                combo->setToolTip("The flag which is set when the hidden item is picked up.");
+            else if (key == "event_flag")
+                combo->setToolTip("The flag which hides the object when set.");
+        } else if (key == "script_var") {
+            listModel = project->getListModel("vars");
+            combo->setToolTip("The variable by which the script is triggered.\n"
+                              "The script is triggered when this variable's value matches 'Var Value'.");
+        } else if (key == "script_var_value") {
+            combo->setToolTip("The variable's value which triggers the script.");
+        } else if (key == "movement_type") {
+            listModel = project->getListModel("movement_types");
+            combo->setToolTip("The object's natural movement behavior when\n"
+                              "the player is not interacting with it.");
+        } else if (key == "weather") {
+            listModel = project->getListModel("coord_event_weather");
+            combo->setToolTip("The weather that starts when the player steps on this spot.");
+        } else if (key == "secret_base_id") {
+            listModel = project->getListModel("secret_bases");
+            combo->setToolTip("The secret base id which is inside this secret\n"
+                              "base entrance. Secret base ids are meant to be\n"
+                              "unique to each and every secret base entrance.");
+        } else if (key == "player_facing_direction") {
+            listModel = project->getListModel("bg_event_facing_directions");
+            combo->setToolTip("The direction which the player must be facing\n"
+                              "to be able to interact with this event.");
+        } else if (key == "radius_x") {
+            combo->setToolTip("The maximum number of metatiles this object\n"
+                              "is allowed to move left or right during its\n"
+                              "normal movement behavior actions.");
+            combo->setMinimumContentsLength(4);
+        } else if (key == "radius_y") {
+            combo->setToolTip("The maximum number of metatiles this object\n"
+                              "is allowed to move up or down during its\n"
+                              "normal movement behavior actions.");
+            combo->setMinimumContentsLength(4);
+        } else if (key == "script_label") {
+            listModel = scriptLabelsModel;
+            combo->setToolTip("The script which is executed with this event.");
+        } else if (key == "trainer_type") {
+            listModel = project->getListModel("trainer_types");
+            combo->setToolTip("The trainer type of this object event.\n"
+                              "If it is not a trainer, use NONE. SEE ALL DIRECTIONS\n"
+                              "should only be used with a sight radius of 1.");
+        } else if (key == "sight_radius_tree_id") {
+            combo->setToolTip("The maximum sight range of a trainer,\n"
+                              "OR the unique id of the berry tree.");
+            combo->setMinimumContentsLength(4);
+        } else if (key == "in_connection") {
+            check->setToolTip("Check if object is positioned in the connection to another map.");
+        } else if (key == "respawn_map") {
+            listModel = project->getListModel("maps");
+            combo->setToolTip("The map where the player will respawn after whiteout.");
+        } else if (key == "respawn_npc") {
+            spin->setToolTip("event_object ID of the NPC the player interacts with\n"
+                             "upon respawning after whiteout.");
+            spin->setMinimum(1);
+            spin->setMaximum(126);
+        }
+
+        if (listModel) {
+            // Typed values are only set on the event, and never added to the shared list.
+            combo->setModel(listModel);
+            combo->setInsertPolicy(QComboBox::NoInsert);
+        }
+
+        // Keys using spin boxes
+        if (spinKeys.contains(key)) {
+            fl->addRow(new QLabel(field_labels[key], widget), spin);
+            // Keys using check boxes
+        } else if (checkKeys.contains(key)) {
+            fl->addRow(new QLabel(field_labels[key], widget), check);
+            // Keys using combo boxes
+        } else if (key == "script_label") {
+            // Add button next to combo which opens combo's current script.
+            auto* hl = new QHBoxLayout();
+            hl->setSpacing(3);
+            auto* openScriptButton = new QToolButton(widget);
+            openScriptButtons << openScriptButton;
+            frame->openScriptButton = openScriptButton;
+            openScriptButton->setFixedSize(combo->height(), combo->height());
+            openScriptButton->setIcon(QFileIconProvider().icon(QFileIconProvider::File));
+            openScriptButton->setToolTip("Go to this script definition in text editor.");
+            connect(openScriptButton, &QToolButton::clicked, [this, combo]() { this->editor->openScript(combo->currentText()); });
+            hl->addWidget(combo);
+            hl->addWidget(openScriptButton);
+            fl->addRow(new QLabel(field_labels[key], widget), hl);
+            if (porymapConfig.getTextEditorGotoLine().isEmpty())
+                openScriptButton->hide();
+        } else {
+            fl->addRow(new QLabel(field_labels[key], widget), combo);
+        }
+
+        widget->setLayout(fl);
+        frame->layout()->addWidget(widget);
+    }
+    return frame;
+}
+
+// Shows the item's event in a frame made by createEventFrame for its type.
+void MainWindow::bindEventFrame(EventPropertiesFrame* frame, DraggablePixmapItem* item, bool showIndex) {
+    frame->setEvent(item->event);
+    QList<QMetaObject::Connection>& connections = frame->connections;
+
+    NoScrollSpinBox* x = frame->ui->spinBox_x;
+    NoScrollSpinBox* y = frame->ui->spinBox_y;
+    NoScrollSpinBox* z = frame->ui->spinBox_z;
+
+    // Values are set before connecting, so showing them isn't recorded as an edit.
+    x->setValue(item->event->x());
+    connections << connect(x, QOverload<int>::of(&QSpinBox::valueChanged), item, [this, item, x](int value) {
+        int delta = value - item->event->x();
+        if (delta)
+            editor->map->editHistory.push(new EventMove(QList<Event*>() << item->event, delta, 0, x->getActionId()));
+    });
+    connections << connect(item, &DraggablePixmapItem::xChanged, x, &NoScrollSpinBox::setValue);
+
+    y->setValue(item->event->y());
+    connections << connect(y, QOverload<int>::of(&QSpinBox::valueChanged), item, [this, item, y](int value) {
+        int delta = value - item->event->y();
+        if (delta)
+            editor->map->editHistory.push(new EventMove(QList<Event*>() << item->event, 0, delta, y->getActionId()));
+    });
+    connections << connect(item, &DraggablePixmapItem::yChanged, y, &NoScrollSpinBox::setValue);
+
+    z->setValue(item->event->elevation());
+    connections << connect(z, &NoScrollSpinBox::textChanged, item, &DraggablePixmapItem::set_elevation);
+    connections << connect(item, &DraggablePixmapItem::elevationChanged, z, &NoScrollSpinBox::setValue);
+
+    QString event_type = item->event->get("event_type");
+    QString event_group_type = item->event->get("event_group_type");
+    QString map_name = item->event->get("map_name");
+    int event_offs;
+    if (event_type == EventType::Warp) {
+        event_offs = 0;
+    } else {
+        event_offs = 1;
+    }
+
+    frame->ui->spinBox_index->setVisible(showIndex);
+    if (showIndex) {
+        QList<Event*> groupEvents = editor->project->getMap(map_name)->events.value(event_group_type);
+        frame->ui->spinBox_index->setMinimum(event_offs);
+        frame->ui->spinBox_index->setMaximum(groupEvents.length() + event_offs - 1);
+        frame->ui->spinBox_index->setValue(groupEvents.indexOf(item->event) + event_offs);
+        connections << connect(frame->ui->spinBox_index, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::selectedEventIndexChanged);
+    }
+
+    frame->ui->label_spritePixmap->setPixmap(item->event->pixmap);
+    connections << connect(item, &DraggablePixmapItem::spriteChanged, frame->ui->label_spritePixmap, &QLabel::setPixmap);
+
+    if (event_type == EventType::Object) {
+        NoScrollComboBox* spriteCombo = frame->ui->comboBox_sprite;
+        spriteCombo->setCurrentIndex(spriteCombo->findText(item->event->get("sprite")));
+        connections << connect(spriteCombo, &QComboBox::currentTextChanged, item, &DraggablePixmapItem::set_sprite);
+    }
+
+    for (auto it = frame->fields.begin(); it != frame->fields.end(); it++) {
+        QString key = it.key();
+        QString value = item->event->get(key);
+
+        if (NoScrollSpinBox* spin = qobject_cast<NoScrollSpinBox*>(it.value())) {
+            spin->setValue(value.toInt());
+            connections << connect(spin, QOverload<int>::of(&NoScrollSpinBox::valueChanged), item, [item, key](int value) { item->event->put(key, value); });
+        } else if (QCheckBox* check = qobject_cast<QCheckBox*>(it.value())) {
+            check->setChecked(value.toInt());
+            connections << connect(check, &QCheckBox::stateChanged, item, [item, key](int state) {
+                switch (state) {
+                case Qt::Checked:
+                    item->event->put(key, true);
+                    break;
+                case Qt::Unchecked:
+                    item->event->put(key, false);
+                    break;
+                }
+            });
+        } else if (NoScrollComboBox* combo = qobject_cast<NoScrollComboBox*>(it.value())) {
+            // Combo boxes without a shared list only hold the current value.
+            if (qobject_cast<QStringListModel*>(combo->model())) {
+                combo->setCurrentIndex(combo->findText(value));
+            } else {
+                combo->clear();
+            }
+            combo->setCurrentText(value);
+
+            if (key == "movement_type") {
+                connections << connect(combo, static_cast<void (QComboBox::*)(const QString&)>(&QComboBox::currentTextChanged), item, [this, item](QString value) {
+                    item->event->setFrameFromMovement(editor->project->facingDirections.value(value));
+                    item->updatePixmap();
+                });
+            }
+            connections << item->bind(combo, key);
+        }
+    }
+
+    if (frame->openScriptButton)
+        frame->openScriptButton->setVisible(!porymapConfig.getTextEditorGotoLine().isEmpty());
+}
+
+// Unbinds the displayed event frames and returns them to the pool.
+void MainWindow::releaseEventFrames() {
+    for (EventPropertiesFrame* frame : boundEventFrames) {
+        frame->unbind();
+        frame->setEvent(nullptr);
+        frame->hide();
+        frame->setParent(this);
+        eventFramePool[frame->eventType].append(frame);
+    }
+    boundEventFrames.clear();
+}
+
+// Deletes every event frame. Needed when the project changes, since the frames use its list models.
+void MainWindow::clearEventFramePool() {
+    releaseEventFrames();
+    for (auto frames : eventFramePool)
+        qDeleteAll(frames);
+    eventFramePool.clear();
+    openScriptButtons.clear();
+}
+
 QString MainWindow::getEventGroupFromTabWidget(QWidget* tab) {
     QString ret = "";
     if (tab == eventTabObjectWidget) {
@@ -2258,6 +2317,7 @@ void MainWindow::onMapNeedsRedrawing() {
 }
 
 void MainWindow::onMapCacheCleared() {
+    releaseEventFrames();
     editor->map = nullptr;
 }
 
@@ -2532,11 +2592,21 @@ void MainWindow::on_actionAbout_Porymap_triggered() {
 }
 
 void MainWindow::on_actionOpen_Log_File_triggered() {
+    flushLog();
     const QString logPath = getLogPath();
     const int lineCount = ParseUtil::textFileLineCount(logPath);
     editor->openInTextEditor(logPath, lineCount);
 }
 
+void MainWindow::on_actionShow_Log_triggered() {
+    if (!this->logViewer) {
+        this->logViewer = new LogViewer(this);
+    }
+    this->logViewer->show();
+    this->logViewer->raise();
+    this->logViewer->activateWindow();
+}
+
 void MainWindow::on_actionOpen_Config_Folder_triggered() {
     QDesktopServices::openUrl(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
 }
@@ -2547,6 +2617,7 @@ void MainWindow::on_actionEdit_Preferences_triggered() {
         connect(preferenceEditor, &PreferenceEditor::themeChanged, this, &MainWindow::setTheme);
         connect(preferenceEditor, &PreferenceEditor::themeChanged, editor, &Editor::maskNonVisibleConnectionTiles);
         connect(preferenceEditor, &PreferenceEditor::preferencesSaved, this, &MainWindow::togglePreferenceSpecificUi);
+        connect(preferenceEditor, &PreferenceEditor::preferencesSaved, this, &MainWindow::trimProjectCaches);
     }
 
     if (!preferenceEditor->isVisible()) {
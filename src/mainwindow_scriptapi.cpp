@@ -24,8 +24,16 @@ void MainWindow::tryCommitMapChanges(bool commitChanges) {
     if (commitChanges) {
         Map* map = this->editor->map;
         if (map) {
-            map->editHistory.push(new ScriptEditMap(map, map->layout->lastCommitMapBlocks.dimensions, QSize(map->getWidth(), map->getHeight()),
-                map->layout->lastCommitMapBlocks.blocks, map->layout->blockdata));
+            QSize dimensions(map->getWidth(), map->getHeight());
+            if (map->layout->lastCommitMapBlocks.dimensions == dimensions) {
+                // Only the blocks that changed since the last commit are kept in the edit history.
+                BlockdataDiff changes(map->layout->lastCommitMapBlocks.blocks, map->layout->blockdata);
+                if (!changes.isEmpty())
+                    map->editHistory.push(new ScriptEditMap(map, changes));
+            } else {
+                map->editHistory.push(new ScriptEditMap(map, map->layout->lastCommitMapBlocks.dimensions, dimensions,
+                    map->layout->lastCommitMapBlocks.blocks, map->layout->blockdata));
+            }
         }
     }
 }
@@ -38,6 +46,26 @@ void MainWindow::setBlock(int x, int y, int tile, int collision, int elevation,
     this->tryRedrawMapArea(forceRedraw);
 }
 
+QJSValue MainWindow::getBlocks(int x, int y, int width, int height) {
+    if (!this->editor || !this->editor->map || width <= 0 || height <= 0)
+        return QJSValue();
+    return Scripting::toUint16Array(this->editor->map->getRawBlocks(QRect(x, y, width, height)));
+}
+
+void MainWindow::setBlocks(int x, int y, int width, int height, QJSValue rawValues, bool forceRedraw, bool commitChanges) {
+    if (!this->editor || !this->editor->map || width <= 0 || height <= 0)
+        return;
+    QRect rect(x, y, width, height);
+    QVector<uint16_t> newValues = Scripting::fromUint16Array(rawValues, width * height);
+    QVector<uint16_t> prevValues;
+    bool notify = Scripting::hasCallback(OnBlocksChanged);
+    this->editor->map->setRawBlocks(rect, newValues, notify ? &prevValues : nullptr);
+    if (notify)
+        Scripting::cb_BlocksChanged(rect, prevValues, newValues);
+    this->tryCommitMapChanges(commitChanges);
+    this->tryRedrawMapArea(forceRedraw);
+}
+
 void MainWindow::setBlocksFromSelection(int x, int y, bool forceRedraw, bool commitChanges) {
     if (this->editor && this->editor->map_item) {
         this->editor->map_item->paintNormal(x, y, true);
@@ -218,29 +246,29 @@ void MainWindow::clearOverlay() {
 void MainWindow::addText(QString text, int x, int y, QString color, int fontSize) {
     if (!this->ui || !this->ui->graphicsView_Map)
         return;
-    this->ui->graphicsView_Map->overlay.addText(text, x, y, color, fontSize);
-    this->ui->graphicsView_Map->scene()->update();
+    QRect bounds = this->ui->graphicsView_Map->overlay.addText(text, x, y, color, fontSize);
+    this->ui->graphicsView_Map->scene()->update(bounds);
 }
 
 void MainWindow::addRect(int x, int y, int width, int height, QString color) {
     if (!this->ui || !this->ui->graphicsView_Map)
         return;
-    this->ui->graphicsView_Map->overlay.addRect(x, y, width, height, color, false);
-    this->ui->graphicsView_Map->scene()->update();
+    QRect bounds = this->ui->graphicsView_Map->overlay.addRect(x, y, width, height, color, false);
+    this->ui->graphicsView_Map->scene()->update(bounds);
 }
 
 void MainWindow::addFilledRect(int x, int y, int width, int height, QString color) {
     if (!this->ui || !this->ui->graphicsView_Map)
         return;
-    this->ui->graphicsView_Map->overlay.addRect(x, y, width, height, color, true);
-    this->ui->graphicsView_Map->scene()->update();
+    QRect bounds = this->ui->graphicsView_Map->overlay.addRect(x, y, width, height, color, true);
+    this->ui->graphicsView_Map->scene()->update(bounds);
 }
 
 void MainWindow::addImage(int x, int y, QString filepath) {
     if (!this->ui || !this->ui->graphicsView_Map)
         return;
-    this->ui->graphicsView_Map->overlay.addImage(x, y, filepath);
-    this->ui->graphicsView_Map->scene()->update();
+    QRect bounds = this->ui->graphicsView_Map->overlay.addImage(x, y, filepath);
+    this->ui->graphicsView_Map->scene()->update(bounds);
 }
 
 void MainWindow::refreshAfterPaletteChange(Tileset* tileset) {
@@ -269,6 +297,7 @@ void MainWindow::setTilesetPalette(Tileset* tileset, int paletteIndex, QList<QLi
         tileset->palettes[paletteIndex][i] = qRgb(colors[i][0], colors[i][1], colors[i][2]);
         tileset->palettePreviews[paletteIndex][i] = qRgb(colors[i][0], colors[i][1], colors[i][2]);
     }
+    tileset->markChanged();
 }
 
 void MainWindow::setPrimaryTilesetPalette(int paletteIndex, QList<QList<int>> colors) {
@@ -371,6 +400,7 @@ void MainWindow::setTilesetPalettePreview(Tileset* tileset, int paletteIndex, QL
             continue;
         tileset->palettePreviews[paletteIndex][i] = qRgb(colors[i][0], colors[i][1], colors[i][2]);
     }
+    tileset->markChanged();
 }
 
 void MainWindow::setPrimaryTilesetPalettePreview(int paletteIndex, QList<QList<int>> colors) {
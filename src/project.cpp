@@ -8,6 +8,7 @@
 #include "tileset.h"
 #include "imageexport.h"
 #include "map.h"
+#include "imageproviders.h"
 
 #include "orderedjson.h"
 
@@ -17,11 +18,19 @@
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QStandardItem>
 #include <QMessageBox>
 #include <QRegularExpression>
+#include <QFileInfo>
+#include <QtConcurrent>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QSet>
 #include <algorithm>
+#include <functional>
 
 using OrderedJson = poryjson::Json;
 using OrderedJsonDoc = poryjson::JsonDoc;
@@ -48,6 +57,17 @@ Project::~Project() {
 void Project::initSignals() {
     // detect changes to specific filepaths being monitored
     QObject::connect(&fileWatcher, &QFileSystemWatcher::fileChanged, [this](QString changed) {
+        parser.invalidateFile(changed);
+        if (changed.startsWith(root + "/src/data/object_events/"))
+            clearEventGraphics();
+        // Files replaced by a rename (like our own saves) are dropped by the watcher, so watch the new file.
+        if (!fileWatcher.files().contains(changed) && QFileInfo::exists(changed))
+            fileWatcher.addPath(changed);
+        // Sprites are only displayed, so there's nothing to reload besides the spritesheet.
+        if (watchedSpritesheets.contains(changed)) {
+            clearEventGraphics();
+            return;
+        }
         if (!porymapConfig.getMonitorFiles())
             return;
         if (modifiedFileTimestamps.contains(changed)) {
@@ -103,6 +123,7 @@ void Project::clearMapCache() {
         if (map)
             delete map;
     }
+    mapLastUsed.clear();
     emit mapCacheCleared();
 }
 
@@ -112,12 +133,15 @@ void Project::clearTilesetCache() {
         if (tileset)
             delete tileset;
     }
+    tilesetLastUsed.clear();
+    clearMetatileImageCache();
 }
 
 Map* Project::loadMap(QString map_name) {
     Map* map;
     if (mapCache.contains(map_name)) {
         map = mapCache.value(map_name);
+        mapLastUsed.insert(map_name, ++cacheUseCounter);
         // TODO: uncomment when undo/redo history is fully implemented for all actions.
         if (true /*map->hasUnsavedChanges()*/) {
             return map;
@@ -130,7 +154,9 @@ Map* Project::loadMap(QString map_name) {
     if (!(loadMapData(map) && loadMapLayout(map)))
         return nullptr;
 
+    map->markSaved();
     mapCache.insert(map_name, map);
+    mapLastUsed.insert(map_name, ++cacheUseCounter);
     return map;
 }
 
@@ -374,10 +400,55 @@ bool Project::loadMapData(Map* map) {
     return true;
 }
 
+static MapHeaderIndexEntry readMapHeaderIndexEntry(const QString& mapFilepath) {
+    MapHeaderIndexEntry entry;
+    entry.lastModified = QFileInfo(mapFilepath).lastModified();
+
+    QFile file(mapFilepath);
+    if (file.open(QIODevice::ReadOnly)) {
+        QJsonObject mapObj = QJsonDocument::fromJson(file.readAll()).object();
+        entry.layoutId = mapObj["layout"].toString();
+        entry.location = mapObj["region_map_section"].toString();
+    }
+    return entry;
+}
+
+// Re-reads the header fields of any map whose map.json is new or has changed since it was indexed.
+// The files are read in parallel, since this is dominated by parsing hundreds of small JSON files.
+void Project::updateMapHeaderIndex() {
+    QStringList staleMaps;
+    QStringList staleFilepaths;
+    for (const QString& mapName : mapNames) {
+        if (mapName == NONE_MAP_NAME || mapCache.contains(mapName))
+            continue;
+        QString mapFilepath = QString("%1/data/maps/%2/map.json").arg(root).arg(mapName);
+        auto it = mapHeaderIndex.constFind(mapName);
+        if (it == mapHeaderIndex.constEnd() || it->lastModified != QFileInfo(mapFilepath).lastModified()) {
+            staleMaps.append(mapName);
+            staleFilepaths.append(mapFilepath);
+        }
+    }
+    if (staleMaps.isEmpty())
+        return;
+
+    QList<MapHeaderIndexEntry> entries = QtConcurrent::blockingMapped(staleFilepaths, readMapHeaderIndexEntry);
+    for (int i = 0; i < staleMaps.length(); i++) {
+        if (entries.at(i).layoutId.isEmpty()) {
+            logError(QString("Failed to read map header from %1").arg(staleFilepaths.at(i)));
+            mapHeaderIndex.remove(staleMaps.at(i));
+        } else {
+            mapHeaderIndex.insert(staleMaps.at(i), entries.at(i));
+        }
+    }
+}
+
 QString Project::readMapLayoutId(QString map_name) {
     if (mapCache.contains(map_name)) {
         return mapCache.value(map_name)->layoutId;
     }
+    if (mapHeaderIndex.contains(map_name)) {
+        return mapHeaderIndex.value(map_name).layoutId;
+    }
 
     QString mapFilepath = QString("%1/data/maps/%2/map.json").arg(root).arg(map_name);
     QJsonDocument mapDoc;
@@ -394,6 +465,9 @@ QString Project::readMapLocation(QString map_name) {
     if (mapCache.contains(map_name)) {
         return mapCache.value(map_name)->location;
     }
+    if (mapHeaderIndex.contains(map_name)) {
+        return mapHeaderIndex.value(map_name).location;
+    }
 
     QString mapFilepath = QString("%1/data/maps/%2/map.json").arg(root).arg(map_name);
     QJsonDocument mapDoc;
@@ -453,7 +527,7 @@ bool Project::readMapLayouts() {
     mapLayoutsTable.clear();
 
     QString layoutsFilepath = QString("%1/data/layouts/layouts.json").arg(root);
-    fileWatcher.addPath(layoutsFilepath);
+    watchFile(layoutsFilepath);
     QJsonDocument layoutsDoc;
     if (!parser.tryParseJsonFile(&layoutsDoc, layoutsFilepath)) {
         logError(QString("Failed to read map layouts from %1").arg(layoutsFilepath));
@@ -505,13 +579,13 @@ bool Project::readMapLayouts() {
             logError(QString("Invalid layout 'width' value '%1' on layout %2 in %3. Must be greater than 0.").arg(lwidth).arg(i).arg(layoutsFilepath));
             return false;
         }
-        layout->width = QString::number(lwidth);
+        layout->width = lwidth;
         int lheight = layoutObj["height"].toInt();
         if (lheight <= 0) {
             logError(QString("Invalid layout 'height' value '%1' on layout %2 in %3. Must be greater than 0.").arg(lheight).arg(i).arg(layoutsFilepath));
             return false;
         }
-        layout->height = QString::number(lheight);
+        layout->height = lheight;
         if (useCustomBorderSize) {
             int bwidth = layoutObj["border_width"].toInt();
             if (bwidth <= 0) { // 0 is an expected border width/height that should be handled, GF used it for the RS layouts in FRLG
@@ -522,7 +596,7 @@ bool Project::readMapLayouts() {
                             .arg(DEFAULT_BORDER_WIDTH));
                 bwidth = DEFAULT_BORDER_WIDTH;
             }
-            layout->border_width = QString::number(bwidth);
+            layout->border_width = bwidth;
             int bheight = layoutObj["border_height"].toInt();
             if (bheight <= 0) {
                 logWarn(QString("Invalid layout 'border_height' value '%1' on layout %2 in %3. Must be greater than 0. Using default (%4) instead.")
@@ -532,10 +606,10 @@ bool Project::readMapLayouts() {
                             .arg(DEFAULT_BORDER_HEIGHT));
                 bheight = DEFAULT_BORDER_HEIGHT;
             }
-            layout->border_height = QString::number(bheight);
+            layout->border_height = bheight;
         } else {
-            layout->border_width = QString::number(DEFAULT_BORDER_WIDTH);
-            layout->border_height = QString::number(DEFAULT_BORDER_HEIGHT);
+            layout->border_width = DEFAULT_BORDER_WIDTH;
+            layout->border_height = DEFAULT_BORDER_HEIGHT;
         }
         layout->tileset_primary_label = layoutObj["primary_tileset"].toString();
         if (layout->tileset_primary_label.isEmpty()) {
@@ -571,11 +645,6 @@ bool Project::readMapLayouts() {
 
 void Project::saveMapLayouts() {
     QString layoutsFilepath = QString("%1/data/layouts/layouts.json").arg(root);
-    QFile layoutsFile(layoutsFilepath);
-    if (!layoutsFile.open(QIODevice::WriteOnly)) {
-        logError(QString("Error: Could not open %1 for writing").arg(layoutsFilepath));
-        return;
-    }
 
     OrderedJson::object layoutsObj;
     layoutsObj["layouts_table_label"] = layoutsLabel;
@@ -587,11 +656,11 @@ void Project::saveMapLayouts() {
         OrderedJson::object layoutObj;
         layoutObj["id"] = layout->id;
         layoutObj["name"] = layout->name;
-        layoutObj["width"] = layout->width.toInt(nullptr, 0);
-        layoutObj["height"] = layout->height.toInt(nullptr, 0);
+        layoutObj["width"] = layout->width;
+        layoutObj["height"] = layout->height;
         if (useCustomBorderSize) {
-            layoutObj["border_width"] = layout->border_width.toInt(nullptr, 0);
-            layoutObj["border_height"] = layout->border_height.toInt(nullptr, 0);
+            layoutObj["border_width"] = layout->border_width;
+            layoutObj["border_height"] = layout->border_height;
         }
         layoutObj["primary_tileset"] = layout->tileset_primary_label;
         layoutObj["secondary_tileset"] = layout->tileset_secondary_label;
@@ -600,13 +669,15 @@ void Project::saveMapLayouts() {
         layoutsArr.push_back(layoutObj);
     }
 
-    ignoreWatchedFileTemporarily(layoutsFilepath);
-
     layoutsObj["layouts"] = layoutsArr;
     OrderedJson layoutJson(layoutsObj);
     OrderedJsonDoc jsonDoc(&layoutJson);
-    jsonDoc.dump(&layoutsFile);
-    layoutsFile.close();
+    writeFile(layoutsFilepath, jsonDoc.toString().toUtf8());
+}
+
+void Project::watchFile(const QString& filepath) {
+    // Project data can be read on worker threads, but the watcher may only be used from the thread it lives in.
+    QMetaObject::invokeMethod(&fileWatcher, [this, filepath]() { fileWatcher.addPath(filepath); });
 }
 
 void Project::ignoreWatchedFileTemporarily(QString filepath) {
@@ -618,8 +689,8 @@ void Project::setNewMapLayout(Map* map) {
     MapLayout* layout = new MapLayout();
     layout->id = MapLayout::layoutConstantFromName(map->name);
     layout->name = QString("%1_Layout").arg(map->name);
-    layout->width = QString::number(getDefaultMapSize());
-    layout->height = QString::number(getDefaultMapSize());
+    layout->width = getDefaultMapSize();
+    layout->height = getDefaultMapSize();
     layout->border_width = DEFAULT_BORDER_WIDTH;
     layout->border_height = DEFAULT_BORDER_HEIGHT;
     layout->border_path = QString("data/layouts/%1/border.bin").arg(map->name);
@@ -637,11 +708,6 @@ void Project::setNewMapLayout(Map* map) {
 
 void Project::saveMapGroups() {
     QString mapGroupsFilepath = QString("%1/data/maps/map_groups.json").arg(root);
-    QFile mapGroupsFile(mapGroupsFilepath);
-    if (!mapGroupsFile.open(QIODevice::WriteOnly)) {
-        logError(QString("Error: Could not open %1 for writing").arg(mapGroupsFilepath));
-        return;
-    }
 
     OrderedJson::object mapGroupsObj;
     mapGroupsObj["layouts_table_label"] = layoutsLabel;
@@ -662,12 +728,9 @@ void Project::saveMapGroups() {
         groupNum++;
     }
 
-    ignoreWatchedFileTemporarily(mapGroupsFilepath);
-
     OrderedJson mapGroupJson(mapGroupsObj);
     OrderedJsonDoc jsonDoc(&mapGroupJson);
-    jsonDoc.dump(&mapGroupsFile);
-    mapGroupsFile.close();
+    writeFile(mapGroupsFilepath, jsonDoc.toString().toUtf8());
 }
 
 void Project::saveWildMonData() {
@@ -675,11 +738,6 @@ void Project::saveWildMonData() {
         return;
 
     QString wildEncountersJsonFilepath = QString("%1/src/data/wild_encounters.json").arg(root);
-    QFile wildEncountersFile(wildEncountersJsonFilepath);
-    if (!wildEncountersFile.open(QIODevice::WriteOnly)) {
-        logError(QString("Error: Could not open %1 for writing").arg(wildEncountersJsonFilepath));
-        return;
-    }
 
     OrderedJson::object wildEncountersObject;
     OrderedJson::array wildEncounterGroups;
@@ -755,11 +813,9 @@ void Project::saveWildMonData() {
 
     wildEncountersObject["wild_encounter_groups"] = wildEncounterGroups;
 
-    ignoreWatchedFileTemporarily(wildEncountersJsonFilepath);
     OrderedJson encounterJson(wildEncountersObject);
     OrderedJsonDoc jsonDoc(&encounterJson);
-    jsonDoc.dump(&wildEncountersFile);
-    wildEncountersFile.close();
+    writeFile(wildEncountersJsonFilepath, jsonDoc.toString().toUtf8());
 }
 
 void Project::saveMapConstantsHeader() {
@@ -794,13 +850,12 @@ void Project::saveMapConstantsHeader() {
     text += QString("#endif // GUARD_CONSTANTS_MAP_GROUPS_H\n");
 
     QString mapGroupFilepath = root + "/include/constants/map_groups.h";
-    ignoreWatchedFileTemporarily(mapGroupFilepath);
     saveTextFile(mapGroupFilepath, text);
 }
 
 // saves heal location coords in root + /src/data/heal_locations.h
 // and indexes as defines in root + /include/constants/heal_locations.h
-void Project::saveHealLocationStruct(Map* map) {
+void Project::saveHealLocations() {
     QString constantPrefix, arrayName;
     if (projectConfig.getHealLocationRespawnDataEnabled()) {
         constantPrefix = "SPAWN_";
@@ -831,14 +886,6 @@ void Project::saveHealLocationStruct(Map* map) {
         healLocationsUnique.insert(xname);
     }
 
-    // set new location in healLocations list
-    if (map->events["heal_event_group"].length() > 0) {
-        for (Event* healEvent : map->events["heal_event_group"]) {
-            HealLocation hl = HealLocation::fromEvent(healEvent);
-            healLocations[hl.index - 1] = hl;
-        }
-    }
-
     int i = 1;
     for (auto map_in : healLocations) {
         // add numbered suffix for duplicate constants
@@ -886,11 +933,9 @@ void Project::saveHealLocationStruct(Map* map) {
     constants_text += QString("\n#endif // GUARD_CONSTANTS_HEAL_LOCATIONS_H\n");
 
     QString healLocationFilepath = root + "/src/data/heal_locations.h";
-    ignoreWatchedFileTemporarily(healLocationFilepath);
     saveTextFile(healLocationFilepath, data_text);
 
     QString healLocationConstantsFilepath = root + "/include/constants/heal_locations.h";
-    ignoreWatchedFileTemporarily(healLocationConstantsFilepath);
     saveTextFile(healLocationConstantsFilepath, constants_text);
 }
 
@@ -981,53 +1026,40 @@ void Project::saveTilesetMetatileLabels(Tileset* primaryTileset, Tileset* second
 
     outputText += "\n#endif // GUARD_METATILE_LABELS_H\n";
 
-    ignoreWatchedFileTemporarily(root + "/" + metatileLabelsFilename);
     saveTextFile(root + "/" + metatileLabelsFilename, outputText);
 }
 
 void Project::saveTilesetMetatileAttributes(Tileset* tileset) {
-    QFile attrs_file(tileset->metatile_attrs_path);
-    if (attrs_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        QByteArray data;
-
-        if (projectConfig.getBaseGameVersion() == BaseGameVersion::pokefirered) {
-            for (Metatile* metatile : tileset->metatiles) {
-                data.append(static_cast<char>(metatile->behavior));
-                data.append(static_cast<char>(metatile->behavior >> 8) | static_cast<char>(metatile->terrainType << 1));
-                data.append(static_cast<char>(0));
-                data.append(static_cast<char>(metatile->encounterType) | static_cast<char>(metatile->layerType << 5));
-            }
-        } else {
-            for (Metatile* metatile : tileset->metatiles) {
-                data.append(static_cast<char>(metatile->behavior));
-                data.append(static_cast<char>((metatile->layerType << 4) & 0xF0));
-            }
+    QByteArray data;
+    if (projectConfig.getBaseGameVersion() == BaseGameVersion::pokefirered) {
+        for (Metatile* metatile : tileset->metatiles) {
+            data.append(static_cast<char>(metatile->behavior));
+            data.append(static_cast<char>(metatile->behavior >> 8) | static_cast<char>(metatile->terrainType << 1));
+            data.append(static_cast<char>(0));
+            data.append(static_cast<char>(metatile->encounterType) | static_cast<char>(metatile->layerType << 5));
         }
-        attrs_file.write(data);
     } else {
-        logError(QString("Could not save tileset metatile attributes file '%1'").arg(tileset->metatile_attrs_path));
+        for (Metatile* metatile : tileset->metatiles) {
+            data.append(static_cast<char>(metatile->behavior));
+            data.append(static_cast<char>((metatile->layerType << 4) & 0xF0));
+        }
     }
+    writeFile(tileset->metatile_attrs_path, data);
 }
 
 void Project::saveTilesetMetatiles(Tileset* tileset) {
-    QFile metatiles_file(tileset->metatiles_path);
-    if (metatiles_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        QByteArray data;
-        for (Metatile* metatile : tileset->metatiles) {
-            int numTiles = projectConfig.getTripleLayerMetatilesEnabled() ? 12 : 8;
-            for (int i = 0; i < numTiles; i++) {
-                Tile tile = metatile->tiles.at(i);
-                uint16_t value
-                    = static_cast<uint16_t>((tile.tile & 0x3ff) | ((tile.xflip & 1) << 10) | ((tile.yflip & 1) << 11) | ((tile.palette & 0xf) << 12));
-                data.append(static_cast<char>(value & 0xff));
-                data.append(static_cast<char>((value >> 8) & 0xff));
-            }
+    QByteArray data;
+    for (Metatile* metatile : tileset->metatiles) {
+        int numTiles = projectConfig.getTripleLayerMetatilesEnabled() ? 12 : 8;
+        for (int i = 0; i < numTiles; i++) {
+            Tile tile = metatile->tiles.at(i);
+            uint16_t value
+                = static_cast<uint16_t>((tile.tile & 0x3ff) | ((tile.xflip & 1) << 10) | ((tile.yflip & 1) << 11) | ((tile.palette & 0xf) << 12));
+            data.append(static_cast<char>(value & 0xff));
+            data.append(static_cast<char>((value >> 8) & 0xff));
         }
-        metatiles_file.write(data);
-    } else {
-        tileset->metatiles.clear();
-        logError(QString("Could not open tileset metatiles file '%1'").arg(tileset->metatiles_path));
     }
+    writeFile(tileset->metatiles_path, data);
 }
 
 void Project::saveTilesetTilesImage(Tileset* tileset) {
@@ -1106,6 +1138,7 @@ Tileset* Project::loadTileset(QString label, Tileset* tileset) {
     loadTilesetAssets(tileset);
 
     tilesetCache.insert(label, tileset);
+    tilesetLastUsed.insert(label, ++cacheUseCounter);
     return tileset;
 }
 
@@ -1116,6 +1149,7 @@ bool Project::loadBlockdata(Map* map) {
 
     QString path = QString("%1/%2").arg(root).arg(map->layout->blockdata_path);
     map->layout->blockdata = readBlockdata(path);
+    map->markAllBlocksDirty();
     map->layout->lastCommitMapBlocks.blocks = map->layout->blockdata;
     map->layout->lastCommitMapBlocks.dimensions = QSize(map->getWidth(), map->getHeight());
 
@@ -1126,6 +1160,7 @@ bool Project::loadBlockdata(Map* map) {
                     .arg(map->getHeight())
                     .arg(map->getWidth() * map->getHeight()));
         map->layout->blockdata.resize(map->getWidth() * map->getHeight());
+        map->layout->markBlocksChanged();
     }
     return true;
 }
@@ -1135,6 +1170,7 @@ void Project::setNewMapBlockdata(Map* map) {
     for (int i = 0; i < map->getWidth() * map->getHeight(); i++) {
         map->layout->blockdata.append(qint16(0x3001));
     }
+    map->markAllBlocksDirty();
     map->layout->lastCommitMapBlocks.blocks = map->layout->blockdata;
     map->layout->lastCommitMapBlocks.dimensions = QSize(map->getWidth(), map->getHeight());
 }
@@ -1146,6 +1182,7 @@ bool Project::loadMapBorder(Map* map) {
 
     QString path = QString("%1/%2").arg(root).arg(map->layout->border_path);
     map->layout->border = readBlockdata(path);
+    map->layout->markBlocksChanged();
     int borderLength = map->getBorderWidth() * map->getBorderHeight();
     if (map->layout->border.count() != borderLength) {
         logWarn(QString("Layout border blockdata length %1 must be %2. Resizing border blockdata.").arg(map->layout->border.count()).arg(borderLength));
@@ -1156,6 +1193,7 @@ bool Project::loadMapBorder(Map* map) {
 
 void Project::setNewMapBorder(Map* map) {
     map->layout->border.clear();
+    map->layout->markBlocksChanged();
     if (map->getBorderWidth() != DEFAULT_BORDER_WIDTH || map->getBorderHeight() != DEFAULT_BORDER_HEIGHT) {
         for (int i = 0; i < map->getBorderWidth() * map->getBorderHeight(); i++) {
             map->layout->border.append(0);
@@ -1184,13 +1222,7 @@ void Project::saveLayoutBlockdata(Map* map) {
 }
 
 void Project::writeBlockdata(QString path, const Blockdata& blockdata) {
-    QFile file(path);
-    if (file.open(QIODevice::WriteOnly)) {
-        QByteArray data = blockdata.serialize();
-        file.write(data);
-    } else {
-        logError(QString("Failed to open blockdata file for writing: '%1'").arg(path));
-    }
+    writeFile(path, blockdata.serialize());
 }
 
 void Project::saveAllMaps() {
@@ -1198,7 +1230,9 @@ void Project::saveAllMaps() {
     for (int i = 0; i < keys.length(); i++) {
         QString key = keys.value(i);
         Map* map = mapCache.value(key);
-        saveMap(map);
+        // Unchanged maps would only rewrite identical files (see writeFile), so skip serializing them.
+        if (map->needsSave())
+            saveMap(map);
     }
 }
 
@@ -1234,46 +1268,10 @@ void Project::saveMap(Map* map) {
         }
     }
 
-    QString layoutsFilepath = QString("%1/data/layouts/layouts.json").arg(root);
-    QJsonDocument layoutsDoc;
-    if (!parser.tryParseJsonFile(&layoutsDoc, layoutsFilepath)) {
-        logError(QString("Failed to read map layouts from %1").arg(layoutsFilepath));
-        return;
-    }
-
-    QFile layoutsFile(layoutsFilepath);
-    if (!layoutsFile.open(QIODevice::ReadWrite)) {
-        logError(QString("Error: Could not open %1 for read/write").arg(layoutsFilepath));
-        return;
-    }
-
-    // Append to "layouts" array in data/layouts/layouts.json.
-    QJsonObject layoutsObj = layoutsDoc.object();
-    QJsonArray layoutsArr = layoutsObj["layouts"].toArray();
-    QJsonObject newLayoutObj;
-    newLayoutObj["id"] = map->layout->id;
-    newLayoutObj["name"] = map->layout->name;
-    newLayoutObj["width"] = map->layout->width.toInt();
-    newLayoutObj["height"] = map->layout->height.toInt();
-    if (projectConfig.getUseCustomBorderSize()) {
-        newLayoutObj["border_width"] = map->layout->border_width.toInt();
-        newLayoutObj["border_height"] = map->layout->border_height.toInt();
-    }
-    newLayoutObj["primary_tileset"] = map->layout->tileset_primary_label;
-    newLayoutObj["secondary_tileset"] = map->layout->tileset_secondary_label;
-    newLayoutObj["border_filepath"] = map->layout->border_path;
-    newLayoutObj["blockdata_filepath"] = map->layout->blockdata_path;
-    layoutsArr.append(newLayoutObj);
-    layoutsFile.write(layoutsDoc.toJson());
-    layoutsFile.close();
+    // The map's layout is written to data/layouts/layouts.json by saveMapLayouts.
 
     // Create map.json for map data.
     QString mapFilepath = QString("%1/map.json").arg(mapDataDir);
-    QFile mapFile(mapFilepath);
-    if (!mapFile.open(QIODevice::WriteOnly)) {
-        logError(QString("Error: Could not open %1 for writing").arg(mapFilepath));
-        return;
-    }
 
     OrderedJson::object mapObj;
     // Header values.
@@ -1338,11 +1336,10 @@ void Project::saveMap(Map* map) {
         OrderedJson::array coordEventsArr;
         for (int i = 0; i < map->events["coord_event_group"].length(); i++) {
             Event* event = map->events["coord_event_group"].value(i);
-            QString event_type = event->get("event_type");
-            if (event_type == EventType::Trigger) {
+            if (event->kind() == Event::Kind::Trigger) {
                 OrderedJson::object triggerObj = event->buildTriggerEventJSON();
                 coordEventsArr.append(triggerObj);
-            } else if (event_type == EventType::WeatherTrigger) {
+            } else if (event->kind() == Event::Kind::WeatherTrigger) {
                 OrderedJson::object weatherObj = event->buildWeatherTriggerEventJSON();
                 coordEventsArr.append(weatherObj);
             }
@@ -1353,14 +1350,13 @@ void Project::saveMap(Map* map) {
         OrderedJson::array bgEventsArr;
         for (int i = 0; i < map->events["bg_event_group"].length(); i++) {
             Event* event = map->events["bg_event_group"].value(i);
-            QString event_type = event->get("event_type");
-            if (event_type == EventType::Sign) {
+            if (event->kind() == Event::Kind::Sign) {
                 OrderedJson::object signObj = event->buildSignEventJSON();
                 bgEventsArr.append(signObj);
-            } else if (event_type == EventType::HiddenItem) {
+            } else if (event->kind() == Event::Kind::HiddenItem) {
                 OrderedJson::object hiddenItemObj = event->buildHiddenItemEventJSON();
                 bgEventsArr.append(hiddenItemObj);
-            } else if (event_type == EventType::SecretBase) {
+            } else if (event->kind() == Event::Kind::SecretBase) {
                 OrderedJson::object secretBaseObj = event->buildSecretBaseEventJSON();
                 bgEventsArr.append(secretBaseObj);
             }
@@ -1381,8 +1377,13 @@ void Project::saveMap(Map* map) {
 
     OrderedJson mapJson(mapObj);
     OrderedJsonDoc jsonDoc(&mapJson);
-    jsonDoc.dump(&mapFile);
-    mapFile.close();
+    writeFile(mapFilepath, jsonDoc.toString().toUtf8());
+
+    MapHeaderIndexEntry headerEntry;
+    headerEntry.lastModified = QFileInfo(mapFilepath).lastModified();
+    headerEntry.layoutId = map->layout->id;
+    headerEntry.location = map->location;
+    mapHeaderIndex.insert(map->name, headerEntry);
 
     saveLayoutBorder(map);
     saveLayoutBlockdata(map);
@@ -1393,6 +1394,7 @@ void Project::saveMap(Map* map) {
 
     map->isPersistedToFile = true;
     map->editHistory.setClean();
+    map->markSaved();
 }
 
 void Project::updateMapLayout(Map* map) {
@@ -1407,11 +1409,13 @@ void Project::updateMapLayout(Map* map) {
     mapLayoutsMaster.insert(map->layoutId, newLayout);
 }
 
+// Files shared by every map are written once here, after the maps themselves.
 void Project::saveAllDataStructures() {
     saveMapLayouts();
     saveMapGroups();
     saveMapConstantsHeader();
     saveWildMonData();
+    saveHealLocations();
 }
 
 void Project::loadTilesetAssets(Tileset* tileset) {
@@ -1515,19 +1519,30 @@ void Project::loadTilesetAssets(Tileset* tileset) {
     }
     tileset->palettes = palettes;
     tileset->palettePreviews = palettePreviews;
+    tileset->markChanged();
 }
 
 void Project::loadTilesetTiles(Tileset* tileset, QImage image) {
-    QList<QImage> tiles;
-    int w = 8;
-    int h = 8;
-    for (int y = 0; y < image.height(); y += h)
-        for (int x = 0; x < image.width(); x += w) {
-            QImage tile = image.copy(x, y, w, h);
-            tiles.append(tile);
+    if (!image.isNull() && image.format() != QImage::Format_Indexed8) {
+        image = image.convertToFormat(QImage::Format_Indexed8);
+    }
+
+    // Rearrange the image's rows of pixels into one 8x8 tile after another.
+    // Any partial tiles on the right and bottom edges are padded with color 0.
+    int tilesWide = (image.width() + 7) / 8;
+    int tilesHigh = (image.height() + 7) / 8;
+    QByteArray pixels(tilesWide * tilesHigh * 64, 0);
+    uchar* dest = reinterpret_cast<uchar*>(pixels.data());
+    for (int y = 0; y < image.height(); y++) {
+        const uchar* src = image.constScanLine(y);
+        uchar* row = dest + (y / 8) * tilesWide * 64 + (y % 8) * 8;
+        for (int x = 0; x < image.width(); x++) {
+            row[(x / 8) * 64 + (x % 8)] = src[x];
         }
+    }
     tileset->tilesImage = image;
-    tileset->tiles = tiles;
+    tileset->tilePixels = pixels;
+    tileset->markChanged();
 }
 
 void Project::loadTilesetMetatiles(Tileset* tileset) {
@@ -1553,8 +1568,10 @@ void Project::loadTilesetMetatiles(Tileset* tileset) {
             }
             metatiles.append(metatile);
         }
+        qDeleteAll(tileset->metatiles);
         tileset->metatiles = metatiles;
     } else {
+        qDeleteAll(tileset->metatiles);
         tileset->metatiles.clear();
         logError(QString("Could not open tileset metatiles file '%1'").arg(tileset->metatiles_path));
     }
@@ -1609,7 +1626,7 @@ void Project::loadTilesetMetatiles(Tileset* tileset) {
 void Project::loadTilesetMetatileLabels(Tileset* tileset) {
     QString tilesetPrefix = QString("METATILE_%1_").arg(QString(tileset->name).replace("gTileset_", ""));
     QString metatileLabelsFilename = "include/constants/metatile_labels.h";
-    fileWatcher.addPath(root + "/" + metatileLabelsFilename);
+    watchFile(root + "/" + metatileLabelsFilename);
     QMap<QString, int> labels = parser.readCDefines(metatileLabelsFilename, QStringList() << tilesetPrefix);
 
     for (QString labelName : labels.keys()) {
@@ -1643,6 +1660,7 @@ Blockdata Project::readBlockdata(QString path) {
 
 Map* Project::getMap(QString map_name) {
     if (mapCache.contains(map_name)) {
+        mapLastUsed.insert(map_name, ++cacheUseCounter);
         return mapCache.value(map_name);
     } else {
         Map* map = loadMap(map_name);
@@ -1650,6 +1668,107 @@ Map* Project::getMap(QString map_name) {
     }
 }
 
+qint64 Project::getCacheMemoryUsage() {
+    qint64 bytes = 0;
+    QSet<MapLayout*> layouts;
+    for (Map* map : mapCache) {
+        bytes += map->memoryUsage();
+        if (map->layout && !layouts.contains(map->layout)) {
+            layouts.insert(map->layout);
+            bytes += map->layout->memoryUsage();
+        }
+    }
+    for (Tileset* tileset : tilesetCache) {
+        if (tileset)
+            bytes += tileset->memoryUsage();
+    }
+    return bytes;
+}
+
+void Project::evictCaches(const QStringList& pinnedMaps) {
+    qint64 budget = qint64(porymapConfig.getCacheBudgetMB()) * 1024 * 1024;
+    qint64 usage = getCacheMemoryUsage();
+    if (usage <= budget)
+        return;
+
+    // Maps edited outside of their undo history (see Map::needsSave) count as unsaved too.
+    QList<QPair<quint64, QString>> evictableMaps;
+    for (auto it = mapCache.constBegin(); it != mapCache.constEnd(); it++) {
+        Map* map = it.value();
+        if (pinnedMaps.contains(it.key()) || map->needsSave())
+            continue;
+        evictableMaps.append(qMakePair(mapLastUsed.value(it.key()), it.key()));
+    }
+    std::sort(evictableMaps.begin(), evictableMaps.end());
+
+    int numMapsEvicted = 0;
+    for (const auto& entry : evictableMaps) {
+        if (usage <= budget)
+            break;
+        Map* map = mapCache.take(entry.second);
+        mapLastUsed.remove(entry.second);
+        usage -= map->memoryUsage();
+
+        // Layouts can be shared, so their data is only released once no loaded map uses them.
+        MapLayout* layout = map->layout;
+        delete map;
+        bool layoutInUse = false;
+        for (Map* other : mapCache) {
+            if (other->layout == layout) {
+                layoutInUse = true;
+                break;
+            }
+        }
+        if (layout && !layoutInUse) {
+            usage -= layout->memoryUsage();
+            layout->releaseData();
+        }
+        numMapsEvicted++;
+    }
+
+    QSet<Tileset*> tilesetsInUse;
+    for (Map* map : mapCache) {
+        if (map->layout) {
+            tilesetsInUse.insert(map->layout->tileset_primary);
+            tilesetsInUse.insert(map->layout->tileset_secondary);
+        }
+    }
+    QList<QPair<quint64, QString>> evictableTilesets;
+    for (auto it = tilesetCache.constBegin(); it != tilesetCache.constEnd(); it++) {
+        if (!tilesetsInUse.contains(it.value()))
+            evictableTilesets.append(qMakePair(tilesetLastUsed.value(it.key()), it.key()));
+    }
+    std::sort(evictableTilesets.begin(), evictableTilesets.end());
+
+    int numTilesetsEvicted = 0;
+    for (const auto& entry : evictableTilesets) {
+        if (usage <= budget)
+            break;
+        Tileset* tileset = tilesetCache.take(entry.second);
+        tilesetLastUsed.remove(entry.second);
+        if (tileset) {
+            usage -= tileset->memoryUsage();
+            // Layouts of unloaded maps may still point to it. They're pointed at the reloaded tileset when their map is next loaded.
+            for (MapLayout* layout : mapLayouts) {
+                if (layout->tileset_primary == tileset)
+                    layout->tileset_primary = nullptr;
+                if (layout->tileset_secondary == tileset)
+                    layout->tileset_secondary = nullptr;
+            }
+            delete tileset;
+        }
+        numTilesetsEvicted++;
+    }
+
+    if (numMapsEvicted || numTilesetsEvicted) {
+        logInfo(QString("Unloaded %1 map(s) and %2 tileset(s) to stay within the %3 MB cache budget. Cache now uses %4 MB.")
+                    .arg(numMapsEvicted)
+                    .arg(numTilesetsEvicted)
+                    .arg(porymapConfig.getCacheBudgetMB())
+                    .arg(usage / (1024 * 1024)));
+    }
+}
+
 Tileset* Project::getTileset(QString label, bool forceLoad) {
     Tileset* existingTileset = nullptr;
     if (tilesetCache.contains(label)) {
@@ -1657,6 +1776,7 @@ Tileset* Project::getTileset(QString label, bool forceLoad) {
     }
 
     if (existingTileset && !forceLoad) {
+        tilesetLastUsed.insert(label, ++cacheUseCounter);
         return existingTileset;
     } else {
         Tileset* tileset = loadTileset(label, existingTileset);
@@ -1665,21 +1785,46 @@ Tileset* Project::getTileset(QString label, bool forceLoad) {
 }
 
 void Project::saveTextFile(QString path, QString text) {
-    QFile file(path);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(text.toUtf8());
-    } else {
-        logError(QString("Could not open '%1' for writing: ").arg(path) + file.errorString());
-    }
+    writeFile(path, text.toUtf8());
 }
 
 void Project::appendTextFile(QString path, QString text) {
     QFile file(path);
-    if (file.open(QIODevice::Append)) {
-        file.write(text.toUtf8());
-    } else {
-        logError(QString("Could not open '%1' for appending: ").arg(path) + file.errorString());
+    QByteArray data;
+    if (file.exists()) {
+        if (!file.open(QIODevice::ReadOnly)) {
+            logError(QString("Could not open '%1' for appending: ").arg(path) + file.errorString());
+            return;
+        }
+        data = file.readAll();
+        file.close();
     }
+    writeFile(path, data + text.toUtf8());
+}
+
+bool Project::writeFile(const QString& path, const QByteArray& data) {
+    QFile existing(path);
+    if (existing.exists() && existing.size() == data.size() && existing.open(QIODevice::ReadOnly)) {
+        bool unchanged = existing.readAll() == data;
+        existing.close();
+        if (unchanged)
+            return false;
+    }
+
+    // The new contents replace the file only once they're fully written, so a failed save can't truncate it.
+    parser.invalidateFile(path);
+    ignoreWatchedFileTemporarily(path);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        logError(QString("Could not open '%1' for writing: ").arg(path) + file.errorString());
+        return false;
+    }
+    file.write(data);
+    if (!file.commit()) {
+        logError(QString("Could not write '%1': ").arg(path) + file.errorString());
+        return false;
+    }
+    return true;
 }
 
 void Project::deleteFile(QString path) {
@@ -1699,7 +1844,7 @@ bool Project::readWildMonData() {
     }
 
     QString wildMonJsonFilepath = QString("%1/src/data/wild_encounters.json").arg(root);
-    fileWatcher.addPath(wildMonJsonFilepath);
+    watchFile(wildMonJsonFilepath);
     QJsonDocument wildMonsJsonDoc;
     if (!parser.tryParseJsonFile(&wildMonsJsonDoc, wildMonJsonFilepath)) {
         logError(QString("Failed to read wild encounters from %1").arg(wildMonJsonFilepath));
@@ -1768,7 +1913,7 @@ bool Project::readMapGroups() {
     mapGroups.clear();
 
     QString mapGroupsFilepath = QString("%1/data/maps/map_groups.json").arg(root);
-    fileWatcher.addPath(mapGroupsFilepath);
+    watchFile(mapGroupsFilepath);
     QJsonDocument mapGroupsDoc;
     if (!parser.tryParseJsonFile(&mapGroupsDoc, mapGroupsFilepath)) {
         logError(QString("Failed to read map groups from %1").arg(mapGroupsFilepath));
@@ -1806,6 +1951,7 @@ bool Project::readMapGroups() {
     groupNames = groups;
     groupedMapNames = groupedMaps;
     mapNames = maps;
+    updateListModels();
     return true;
 }
 
@@ -1814,6 +1960,7 @@ Map* Project::addNewMapToGroup(QString mapName, int groupNum) {
     mapNames.append(mapName);
     mapGroups.insert(mapName, groupNum);
     groupedMapNames[groupNum].append(mapName);
+    updateListModels();
 
     Map* map = new Map;
     map->isPersistedToFile = false;
@@ -1828,6 +1975,7 @@ Map* Project::addNewMapToGroup(QString mapName, int groupNum) {
     setNewMapEvents(map);
     setNewMapConnections(map);
     mapCache.insert(mapName, map);
+    mapLastUsed.insert(mapName, ++cacheUseCounter);
 
     return map;
 }
@@ -1836,6 +1984,7 @@ Map* Project::addNewMapToGroup(QString mapName, int groupNum, Map* newMap, bool
     mapNames.append(mapName);
     mapGroups.insert(mapName, groupNum);
     groupedMapNames[groupNum].append(mapName);
+    updateListModels();
 
     Map* map = new Map;
     map = newMap;
@@ -1930,11 +2079,121 @@ QMap<QString, QStringList> Project::getTilesetLabels() {
     return allTilesets;
 }
 
+// Reads the project's constants and data tables. Readers that don't depend on each other run concurrently
+// on the global thread pool, so opening a project takes about as long as its slowest file.
+// Each reader fills in its own members, so their results are ready once this returns.
+bool Project::readDataStructures() {
+    struct Reader {
+        QString name;
+        bool (Project::*read)();
+        QStringList dependencies;
+    };
+    const QList<Reader> readers = {
+        { "layouts", &Project::readMapLayouts, {} },
+        { "region_map_sections", &Project::readRegionMapSections, {} },
+        { "items", &Project::readItemNames, {} },
+        { "flags", &Project::readFlagNames, {} },
+        { "vars", &Project::readVarNames, {} },
+        { "movement_types", &Project::readMovementTypes, {} },
+        { "facing_directions", &Project::readInitialFacingDirections, {} },
+        { "map_types", &Project::readMapTypes, {} },
+        { "battle_scenes", &Project::readMapBattleScenes, {} },
+        { "weather", &Project::readWeatherNames, {} },
+        { "coord_event_weather", &Project::readCoordEventWeatherNames, {} },
+        { "secret_bases", &Project::readSecretBaseIds, {} },
+        { "bg_event_facing_directions", &Project::readBgEventFacingDirections, {} },
+        { "trainer_types", &Project::readTrainerTypes, {} },
+        { "metatile_behaviors", &Project::readMetatileBehaviors, {} },
+        { "tileset_properties", &Project::readTilesetProperties, {} },
+        { "max_map_data_size", &Project::readMaxMapDataSize, {} },
+        { "heal_locations", &Project::readHealLocations, {} },
+        { "misc_constants", &Project::readMiscellaneousConstants, {} },
+        { "species_icons", &Project::readSpeciesIconPaths, {} },
+        { "wild_encounters", &Project::readWildMonData, {} },
+    };
+
+    readingCanceled.storeRelaxed(0);
+    speciesIcons.clear();
+    QVector<qint64> readTimes(readers.length(), 0);
+    QSet<QString> finished;
+    QSet<int> started;
+    int running = 0;
+    bool success = true;
+    QEventLoop loop;
+
+    std::function<void()> startReadyReaders = [&]() {
+        if (!success || readingCanceled.loadRelaxed())
+            return;
+        for (int i = 0; i < readers.length(); i++) {
+            if (started.contains(i))
+                continue;
+            bool ready = true;
+            for (const QString& dependency : readers.at(i).dependencies) {
+                if (!finished.contains(dependency)) {
+                    ready = false;
+                    break;
+                }
+            }
+            if (!ready)
+                continue;
+
+            started.insert(i);
+            running++;
+            QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>(&loop);
+            connect(watcher, &QFutureWatcher<bool>::finished, &loop, [&, i, watcher]() {
+                running--;
+                if (watcher->result()) {
+                    finished.insert(readers.at(i).name);
+                } else {
+                    success = false;
+                }
+                emit dataStructuresReadProgress(finished.size(), readers.length());
+                startReadyReaders();
+                if (!running)
+                    loop.quit();
+            });
+            bool (Project::*read)() = readers.at(i).read;
+            qint64* readTime = &readTimes[i];
+            watcher->setFuture(QtConcurrent::run([this, read, readTime]() {
+                QElapsedTimer timer;
+                timer.start();
+                bool result = (this->*read)();
+                *readTime = timer.elapsed();
+                return result;
+            }));
+        }
+    };
+
+    emit dataStructuresReadProgress(0, readers.length());
+    startReadyReaders();
+    if (running)
+        loop.exec();
+
+    dataStructureReadTimes.clear();
+    for (int i = 0; i < readers.length(); i++) {
+        if (started.contains(i))
+            dataStructureReadTimes.append(qMakePair(readers.at(i).name, readTimes.at(i)));
+    }
+
+    if (readingCanceled.loadRelaxed()) {
+        logWarn("Opening the project was canceled.");
+        return false;
+    }
+    success = success && finished.size() == readers.length();
+    if (success)
+        updateListModels();
+    return success;
+}
+
+void Project::cancelReadingDataStructures() {
+    readingCanceled.storeRelaxed(1);
+}
+
 bool Project::readTilesetProperties() {
     QStringList definePrefixes;
     definePrefixes << "\\bNUM_";
     QString filename = "include/fieldmap.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     QMap<QString, int> defines = parser.readCDefines(filename, definePrefixes);
 
     auto it = defines.find("NUM_TILES_IN_PRIMARY");
@@ -1979,7 +2238,8 @@ bool Project::readTilesetProperties() {
 bool Project::readMaxMapDataSize() {
     QStringList definePrefixes;
     definePrefixes << "\\bMAX_";
-    QString filename = "include/fieldmap.h"; // already in fileWatcher from readTilesetProperties
+    QString filename = "include/fieldmap.h";
+    watchFile(root + "/" + filename);
     QMap<QString, int> defines = parser.readCDefines(filename, definePrefixes);
 
     auto it = defines.find("MAX_MAP_DATA_SIZE");
@@ -2007,7 +2267,7 @@ bool Project::readRegionMapSections() {
 
     QStringList prefixes = (QStringList() << "\\bMAPSEC_");
     QString filename = "include/constants/region_map_sections.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     this->mapSectionNameToValue = parser.readCDefines(filename, prefixes);
     if (this->mapSectionNameToValue.isEmpty()) {
         logError(QString("Failed to read region map sections from %1.").arg(filename));
@@ -2024,7 +2284,7 @@ bool Project::readHealLocations() {
     dataQualifiers.clear();
     healLocations.clear();
     QString filename = "src/data/heal_locations.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     QString text = parser.readTextFile(root + "/" + filename);
     text.replace(QRegularExpression("//.*?(\r\n?|\n)|/\\*.*?\\*/", QRegularExpression::DotMatchesEverythingOption), "");
 
@@ -2076,7 +2336,7 @@ bool Project::readHealLocations() {
 bool Project::readItemNames() {
     QStringList prefixes("\\bITEM_(?!(B_)?USE_)"); // Exclude ITEM_USE_ and ITEM_B_USE_ constants
     QString filename = "include/constants/items.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     itemNames = parser.readCDefinesSorted(filename, prefixes);
     if (itemNames.isEmpty()) {
         logError(QString("Failed to read item constants from %1").arg(filename));
@@ -2089,12 +2349,12 @@ bool Project::readFlagNames() {
     // First read MAX_TRAINERS_COUNT, used to skip over trainer flags
     // If this fails flags may simply be out of order, no need to check for success
     QString opponentsFilename = "include/constants/opponents.h";
-    fileWatcher.addPath(root + "/" + opponentsFilename);
+    watchFile(root + "/" + opponentsFilename);
     QMap<QString, int> maxTrainers = parser.readCDefines(opponentsFilename, QStringList() << "\\bMAX_");
     // Parse flags
     QStringList prefixes("\\bFLAG_");
     QString flagsFilename = "include/constants/flags.h";
-    fileWatcher.addPath(root + "/" + flagsFilename);
+    watchFile(root + "/" + flagsFilename);
     flagNames = parser.readCDefinesSorted(flagsFilename, prefixes, maxTrainers);
     if (flagNames.isEmpty()) {
         logError(QString("Failed to read flag constants from %1").arg(flagsFilename));
@@ -2106,7 +2366,7 @@ bool Project::readFlagNames() {
 bool Project::readVarNames() {
     QStringList prefixes("\\bVAR_");
     QString filename = "include/constants/vars.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     varNames = parser.readCDefinesSorted(filename, prefixes);
     if (varNames.isEmpty()) {
         logError(QString("Failed to read var constants from %1").arg(filename));
@@ -2118,7 +2378,7 @@ bool Project::readVarNames() {
 bool Project::readMovementTypes() {
     QStringList prefixes("\\bMOVEMENT_TYPE_");
     QString filename = "include/constants/event_object_movement.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     movementTypes = parser.readCDefinesSorted(filename, prefixes);
     if (movementTypes.isEmpty()) {
         logError(QString("Failed to read movement type constants from %1").arg(filename));
@@ -2129,7 +2389,7 @@ bool Project::readMovementTypes() {
 
 bool Project::readInitialFacingDirections() {
     QString filename = "src/event_object_movement.c";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     facingDirections = parser.readNamedIndexCArray(filename, "gInitialMovementTypeFacingDirections");
     if (facingDirections.isEmpty()) {
         logError(QString("Failed to read initial movement type facing directions from %1").arg(filename));
@@ -2141,7 +2401,7 @@ bool Project::readInitialFacingDirections() {
 bool Project::readMapTypes() {
     QStringList prefixes("\\bMAP_TYPE_");
     QString filename = "include/constants/map_types.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     mapTypes = parser.readCDefinesSorted(filename, prefixes);
     if (mapTypes.isEmpty()) {
         logError(QString("Failed to read map type constants from %1").arg(filename));
@@ -2153,7 +2413,7 @@ bool Project::readMapTypes() {
 bool Project::readMapBattleScenes() {
     QStringList prefixes("\\bMAP_BATTLE_SCENE_");
     QString filename = "include/constants/map_types.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     mapBattleScenes = parser.readCDefinesSorted("include/constants/map_types.h", prefixes);
     if (mapBattleScenes.isEmpty()) {
         logError(QString("Failed to read map battle scene constants from %1").arg(filename));
@@ -2165,7 +2425,7 @@ bool Project::readMapBattleScenes() {
 bool Project::readWeatherNames() {
     QStringList prefixes("\\bWEATHER_");
     QString filename = "include/constants/weather.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     weatherNames = parser.readCDefinesSorted(filename, prefixes);
     if (weatherNames.isEmpty()) {
         logError(QString("Failed to read weather constants from %1").arg(filename));
@@ -2180,7 +2440,7 @@ bool Project::readCoordEventWeatherNames() {
 
     QStringList prefixes("\\bCOORD_EVENT_WEATHER_");
     QString filename = "include/constants/weather.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     coordEventWeatherNames = parser.readCDefinesSorted(filename, prefixes);
     if (coordEventWeatherNames.isEmpty()) {
         logError(QString("Failed to read coord event weather constants from %1").arg(filename));
@@ -2195,7 +2455,7 @@ bool Project::readSecretBaseIds() {
 
     QStringList prefixes("\\bSECRET_BASE_[A-Za-z0-9_]*_[0-9]+");
     QString filename = "include/constants/secret_bases.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     secretBaseIds = parser.readCDefinesSorted(filename, prefixes);
     if (secretBaseIds.isEmpty()) {
         logError(QString("Failed to read secret base id constants from %1").arg(filename));
@@ -2207,7 +2467,7 @@ bool Project::readSecretBaseIds() {
 bool Project::readBgEventFacingDirections() {
     QStringList prefixes("\\bBG_EVENT_PLAYER_FACING_");
     QString filename = "include/constants/event_bg.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     bgEventFacingDirections = parser.readCDefinesSorted(filename, prefixes);
     if (bgEventFacingDirections.isEmpty()) {
         logError(QString("Failed to read bg event facing direction constants from %1").arg(filename));
@@ -2219,7 +2479,7 @@ bool Project::readBgEventFacingDirections() {
 bool Project::readTrainerTypes() {
     QStringList prefixes("\\bTRAINER_TYPE_");
     QString filename = "include/constants/trainer_types.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     trainerTypes = parser.readCDefinesSorted(filename, prefixes);
     if (trainerTypes.isEmpty()) {
         logError(QString("Failed to read trainer type constants from %1").arg(filename));
@@ -2234,7 +2494,7 @@ bool Project::readMetatileBehaviors() {
 
     QStringList prefixes("\\bMB_");
     QString filename = "include/constants/metatile_behaviors.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     this->metatileBehaviorMap = parser.readCDefines(filename, prefixes);
     if (this->metatileBehaviorMap.isEmpty()) {
         logError(QString("Failed to read metatile behaviors from %1.").arg(filename));
@@ -2250,7 +2510,7 @@ bool Project::readMetatileBehaviors() {
 QStringList Project::getSongNames() {
     QStringList songDefinePrefixes{ "\\bSE_", "\\bMUS_" };
     QString filename = "include/constants/songs.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     QMap<QString, int> songDefines = parser.readCDefines(filename, songDefinePrefixes);
     QStringList names = songDefines.keys();
     this->defaultSong = names.value(0, "MUS_DUMMY");
@@ -2258,11 +2518,68 @@ QStringList Project::getSongNames() {
     return names;
 }
 
+QStringListModel* Project::getListModel(const QString& name) {
+    QStringListModel* model = listModels.value(name);
+    if (!model) {
+        model = new QStringListModel(getListModelStrings(name), this);
+        listModels.insert(name, model);
+    }
+    return model;
+}
+
+QStringList Project::getListModelStrings(const QString& name) {
+    if (name == "flags")
+        return flagNames;
+    if (name == "vars")
+        return varNames;
+    if (name == "items")
+        return itemNames;
+    if (name == "maps")
+        return mapNames;
+    if (name == "movement_types")
+        return movementTypes;
+    if (name == "trainer_types")
+        return trainerTypes;
+    if (name == "coord_event_weather")
+        return coordEventWeatherNames;
+    if (name == "secret_bases")
+        return secretBaseIds;
+    if (name == "bg_event_facing_directions")
+        return bgEventFacingDirections;
+    if (name == "object_event_graphics")
+        return getEventObjGfxConstants().keys();
+    if (name == "species")
+        return speciesToIconPath.keys();
+    logWarn(QString("Unknown list model '%1'").arg(name));
+    return QStringList();
+}
+
+void Project::updateListModels() {
+    for (auto it = listModels.begin(); it != listModels.end(); it++) {
+        QStringListModel* model = it.value();
+        const QStringList strings = getListModelStrings(it.key());
+        const QStringList current = model->stringList();
+        if (strings == current)
+            continue;
+
+        // Resetting the model clears the text of every combo box using it, so items added
+        // to the end (like new maps) are inserted instead.
+        if (strings.length() > current.length() && strings.mid(0, current.length()) == current) {
+            int first = current.length();
+            model->insertRows(first, strings.length() - first);
+            for (int i = first; i < strings.length(); i++)
+                model->setData(model->index(i), strings.at(i));
+        } else {
+            model->setStringList(strings);
+        }
+    }
+}
+
 QMap<QString, int> Project::getEventObjGfxConstants() {
     QStringList eventObjGfxPrefixes("\\bOBJ_EVENT_GFX_");
 
     QString filename = "include/constants/event_objects.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     QMap<QString, int> constants = parser.readCDefines(filename, eventObjGfxPrefixes);
 
     return constants;
@@ -2272,7 +2589,7 @@ bool Project::readMiscellaneousConstants() {
     miscConstants.clear();
     if (projectConfig.getEncounterJsonActive()) {
         QString filename = "include/constants/pokemon.h";
-        fileWatcher.addPath(root + "/" + filename);
+        watchFile(root + "/" + filename);
         QMap<QString, int> pokemonDefines = parser.readCDefines(filename, { "MIN_", "MAX_" });
         miscConstants.insert(
             "max_level_define", pokemonDefines.value("MAX_LEVEL") > pokemonDefines.value("MIN_LEVEL") ? pokemonDefines.value("MAX_LEVEL") : 100);
@@ -2280,7 +2597,7 @@ bool Project::readMiscellaneousConstants() {
     }
 
     QString filename = "include/constants/global.h";
-    fileWatcher.addPath(root + "/" + filename);
+    watchFile(root + "/" + filename);
     QStringList definePrefixes("\\bOBJECT_");
     QMap<QString, int> defines = parser.readCDefines(filename, definePrefixes);
 
@@ -2375,15 +2692,8 @@ void Project::loadEventPixmaps(QList<Event*> objects) {
         return;
     }
 
-    QMap<QString, int> constants = getEventObjGfxConstants();
-
-    fileWatcher.addPaths(QStringList() << root + "/" + "src/data/object_events/object_event_graphics_info_pointers.h"
-                                       << root + "/" + "src/data/object_events/object_event_graphics_info.h"
-                                       << root + "/" + "src/data/object_events/object_event_pic_tables.h"
-                                       << root + "/" + "src/data/object_events/object_event_graphics.h");
-
-    QMap<QString, QString> pointerHash
-        = parser.readNamedIndexCArray("src/data/object_events/object_event_graphics_info_pointers.h", "gObjectEventGraphicsInfoPointers");
+    readEventGraphics();
+    QPixmap entities(":/images/Entities_16x16.png");
 
     for (Event* object : objects) {
         if (!object->pixmap.isNull()) {
@@ -2393,61 +2703,126 @@ void Project::loadEventPixmaps(QList<Event*> objects) {
         object->spriteWidth = 16;
         object->spriteHeight = 16;
         object->usingSprite = false;
-        QString event_type = object->get("event_type");
-        if (event_type == EventType::Object) {
-            object->pixmap = QPixmap(":/images/Entities_16x16.png").copy(0, 0, 16, 16);
-        } else if (event_type == EventType::Warp) {
-            object->pixmap = QPixmap(":/images/Entities_16x16.png").copy(16, 0, 16, 16);
-        } else if (event_type == EventType::Trigger || event_type == EventType::WeatherTrigger) {
-            object->pixmap = QPixmap(":/images/Entities_16x16.png").copy(32, 0, 16, 16);
-        } else if (event_type == EventType::Sign || event_type == EventType::HiddenItem || event_type == EventType::SecretBase) {
-            object->pixmap = QPixmap(":/images/Entities_16x16.png").copy(48, 0, 16, 16);
-        } else if (event_type == EventType::HealLocation) {
-            object->pixmap = QPixmap(":/images/Entities_16x16.png").copy(64, 0, 16, 16);
-        }
-
-        if (event_type == EventType::Object) {
-            QString info_label = pointerHash[object->get("sprite")].replace("&", "");
-            QStringList gfx_info = parser.readCArray("src/data/object_events/object_event_graphics_info.h", info_label);
-            QString pic_label = gfx_info.value(14);
-            QString dimensions_label = gfx_info.value(11);
-            QString subsprites_label = gfx_info.value(12);
-            QString gfx_label = parser.readCArray("src/data/object_events/object_event_pic_tables.h", pic_label).value(0);
-            gfx_label = gfx_label.section(QRegExp("[\\(\\)]"), 1, 1);
-            QString path = parser.readCIncbin("src/data/object_events/object_event_graphics.h", gfx_label);
-
-            if (!path.isNull()) {
-                path = fixGraphicPath(path);
-                QImage spritesheet(root + "/" + path);
-                if (!spritesheet.isNull()) {
-                    // Infer the sprite dimensions from the OAM labels.
-                    int spriteWidth, spriteHeight;
-                    QRegularExpression re("\\S+_(\\d+)x(\\d+)");
-                    QRegularExpressionMatch dimensionMatch = re.match(dimensions_label);
-                    QRegularExpressionMatch oamTablesMatch = re.match(subsprites_label);
-                    if (oamTablesMatch.hasMatch()) {
-                        spriteWidth = oamTablesMatch.captured(1).toInt();
-                        spriteHeight = oamTablesMatch.captured(2).toInt();
-                    } else if (dimensionMatch.hasMatch()) {
-                        spriteWidth = dimensionMatch.captured(1).toInt();
-                        spriteHeight = dimensionMatch.captured(2).toInt();
-                    } else {
-                        spriteWidth = spritesheet.width();
-                        spriteHeight = spritesheet.height();
-                    }
-                    object->setPixmapFromSpritesheet(spritesheet, spriteWidth, spriteHeight, object->frame, object->hFlip);
+        switch (object->kind()) {
+        case Event::Kind::Object:
+            object->pixmap = entities.copy(0, 0, 16, 16);
+            break;
+        case Event::Kind::Warp:
+            object->pixmap = entities.copy(16, 0, 16, 16);
+            break;
+        case Event::Kind::Trigger:
+        case Event::Kind::WeatherTrigger:
+            object->pixmap = entities.copy(32, 0, 16, 16);
+            break;
+        case Event::Kind::Sign:
+        case Event::Kind::HiddenItem:
+        case Event::Kind::SecretBase:
+            object->pixmap = entities.copy(48, 0, 16, 16);
+            break;
+        case Event::Kind::HealLocation:
+            object->pixmap = entities.copy(64, 0, 16, 16);
+            break;
+        case Event::Kind::Unknown:
+            break;
+        }
+
+        if (object->kind() == Event::Kind::Object) {
+            auto it = eventGraphics.find(object->get("sprite"));
+            if (it == eventGraphics.end() || it->spritesheetPath.isNull()) {
+                continue;
+            }
+            EventGraphics& graphics = it.value();
+            if (!graphics.spritesheetLoaded) {
+                QString spritesheetPath = root + "/" + graphics.spritesheetPath;
+                graphics.spritesheet = QImage(spritesheetPath);
+                graphics.spritesheetLoaded = true;
+                if (!watchedSpritesheets.contains(spritesheetPath)) {
+                    watchedSpritesheets.insert(spritesheetPath);
+                    watchFile(spritesheetPath);
                 }
+                if (graphics.spriteWidth <= 0 || graphics.spriteHeight <= 0) {
+                    graphics.spriteWidth = graphics.spritesheet.width();
+                    graphics.spriteHeight = graphics.spritesheet.height();
+                }
+            }
+            if (graphics.spritesheet.isNull()) {
+                continue;
+            }
+
+            int frameKey = object->frame * 2 + (object->hFlip ? 1 : 0);
+            auto frame = graphics.framePixmaps.constFind(frameKey);
+            if (frame != graphics.framePixmaps.constEnd()) {
+                object->setSpritePixmap(frame.value(), graphics.spriteWidth, graphics.spriteHeight);
+            } else {
+                object->setPixmapFromSpritesheet(graphics.spritesheet, graphics.spriteWidth, graphics.spriteHeight, object->frame, object->hFlip);
+                graphics.framePixmaps.insert(frameKey, object->pixmap);
             }
         }
     }
 }
 
+void Project::readEventGraphics() {
+    if (eventGraphicsRead) {
+        return;
+    }
+    eventGraphicsRead = true;
+    eventGraphics.clear();
+
+    const QString pointersFilename = "src/data/object_events/object_event_graphics_info_pointers.h";
+    const QString infoFilename = "src/data/object_events/object_event_graphics_info.h";
+    const QString picTablesFilename = "src/data/object_events/object_event_pic_tables.h";
+    const QString graphicsFilename = "src/data/object_events/object_event_graphics.h";
+    watchFile(root + "/" + pointersFilename);
+    watchFile(root + "/" + infoFilename);
+    watchFile(root + "/" + picTablesFilename);
+    watchFile(root + "/" + graphicsFilename);
+
+    QMap<QString, QString> pointerHash = parser.readNamedIndexCArray(pointersFilename, "gObjectEventGraphicsInfoPointers");
+    QHash<QString, QStringList> graphicsInfos = parser.readCArrays(infoFilename);
+    QHash<QString, QStringList> picTables = parser.readCArrays(picTablesFilename);
+    QHash<QString, QString> incbins = parser.readCIncbins(graphicsFilename);
+
+    // Infer the sprite dimensions from the OAM labels.
+    QRegularExpression re("\\S+_(\\d+)x(\\d+)");
+    for (auto it = pointerHash.constBegin(); it != pointerHash.constEnd(); it++) {
+        QString info_label = QString(it.value()).remove("&");
+        QStringList gfx_info = graphicsInfos.value(info_label);
+        QString pic_label = gfx_info.value(14);
+        QString dimensions_label = gfx_info.value(11);
+        QString subsprites_label = gfx_info.value(12);
+        QString gfx_label = picTables.value(pic_label).value(0);
+        gfx_label = gfx_label.section(QRegExp("[\\(\\)]"), 1, 1);
+
+        EventGraphics graphics;
+        QString path = gfx_label.isEmpty() ? QString() : incbins.value(gfx_label);
+        if (!path.isNull()) {
+            graphics.spritesheetPath = fixGraphicPath(path);
+        }
+        QRegularExpressionMatch dimensionMatch = re.match(dimensions_label);
+        QRegularExpressionMatch oamTablesMatch = re.match(subsprites_label);
+        if (oamTablesMatch.hasMatch()) {
+            graphics.spriteWidth = oamTablesMatch.captured(1).toInt();
+            graphics.spriteHeight = oamTablesMatch.captured(2).toInt();
+        } else if (dimensionMatch.hasMatch()) {
+            graphics.spriteWidth = dimensionMatch.captured(1).toInt();
+            graphics.spriteHeight = dimensionMatch.captured(2).toInt();
+        }
+        eventGraphics.insert(it.key(), graphics);
+    }
+}
+
+void Project::clearEventGraphics() {
+    eventGraphics.clear();
+    watchedSpritesheets.clear();
+    eventGraphicsRead = false;
+}
+
 bool Project::readSpeciesIconPaths() {
     speciesToIconPath.clear();
     QString srcfilename = "src/pokemon_icon.c";
     QString incfilename = "src/data/graphics/pokemon.h";
-    fileWatcher.addPath(root + "/" + srcfilename);
-    fileWatcher.addPath(root + "/" + incfilename);
+    watchFile(root + "/" + srcfilename);
+    watchFile(root + "/" + incfilename);
     QMap<QString, QString> monIconNames = parser.readNamedIndexCArray(srcfilename, "gMonIconTable");
     for (QString species : monIconNames.keys()) {
         QString path = parser.readCIncbin(incfilename, monIconNames.value(species));
@@ -2456,15 +2831,27 @@ bool Project::readSpeciesIconPaths() {
     return true;
 }
 
+QPixmap Project::getSpeciesIcon(const QString& species) {
+    auto it = speciesIcons.constFind(species);
+    if (it != speciesIcons.constEnd())
+        return it.value();
+
+    QPixmap icon;
+    QString path = speciesToIconPath.value(species);
+    if (!path.isEmpty())
+        icon = QPixmap(path).copy(0, 0, 32, 32);
+    speciesIcons.insert(species, icon);
+    return icon;
+}
+
+// Updates the project's heal locations with the map's heal events. They're written by saveHealLocations.
 void Project::saveMapHealEvents(Map* map) {
-    // save heal event changes
     if (map->events["heal_event_group"].length() > 0) {
         for (Event* healEvent : map->events["heal_event_group"]) {
             HealLocation hl = HealLocation::fromEvent(healEvent);
             healLocations[hl.index - 1] = hl;
         }
     }
-    saveHealLocationStruct(map);
 }
 
 void Project::setNewMapEvents(Map* map) {
@@ -1,8 +1,14 @@
 #include "scripting.h"
 #include "log.h"
 
+#include <cstring>
+
 QMap<CallbackType, QString> callbackFunctions = {
-    { OnProjectOpened, "onProjectOpened" }, { OnProjectClosed, "onProjectClosed" }, { OnBlockChanged, "onBlockChanged" }, { OnMapOpened, "onMapOpened" },
+    { OnProjectOpened, "onProjectOpened" },
+    { OnProjectClosed, "onProjectClosed" },
+    { OnBlockChanged, "onBlockChanged" },
+    { OnBlocksChanged, "onBlocksChanged" },
+    { OnMapOpened, "onMapOpened" },
 };
 
 Scripting* instance = nullptr;
@@ -45,25 +51,31 @@ void Scripting::loadModules(QStringList moduleFiles) {
 
         logInfo(QString("Successfully loaded custom script file '%1'").arg(filepath));
         this->modules.append(module);
+        for (auto it = callbackFunctions.constBegin(); it != callbackFunctions.constEnd(); it++) {
+            QJSValue callbackFunction = module.property(it.value());
+            if (callbackFunction.isCallable()) {
+                this->callbacks[it.key()].append(qMakePair(module, callbackFunction));
+            }
+        }
     }
 }
 
 void Scripting::invokeCallback(CallbackType type, QJSValueList args) {
-    for (QJSValue module : this->modules) {
-        QString functionName = callbackFunctions[type];
-        QJSValue callbackFunction = module.property(functionName);
-        if (callbackFunction.isError()) {
-            continue;
-        }
-
-        QJSValue result = callbackFunction.call(args);
+    for (const auto& callback : this->callbacks.value(type)) {
+        QJSValue result = callback.second.call(args);
         if (result.isError()) {
-            logError(QString("Module %1 encountered an error when calling '%2'").arg(module.toString()).arg(functionName));
+            logError(QString("Module %1 encountered an error when calling '%2'").arg(callback.first.toString()).arg(callbackFunctions[type]));
             continue;
         }
     }
 }
 
+bool Scripting::hasCallback(CallbackType type) {
+    if (!instance)
+        return false;
+    return !instance->callbacks.value(type).isEmpty();
+}
+
 void Scripting::registerAction(QString functionName, QString actionName) {
     if (!instance)
         return;
@@ -118,7 +130,7 @@ void Scripting::cb_ProjectClosed(QString projectPath) {
 }
 
 void Scripting::cb_MetatileChanged(int x, int y, Block prevBlock, Block newBlock) {
-    if (!instance)
+    if (!instance || !hasCallback(OnBlockChanged))
         return;
 
     QJSValueList args{
@@ -127,6 +139,19 @@ void Scripting::cb_MetatileChanged(int x, int y, Block prevBlock, Block newBlock
     instance->invokeCallback(OnBlockChanged, args);
 }
 
+void Scripting::cb_BlocksChanged(const QRect& rect, const QVector<uint16_t>& prevValues, const QVector<uint16_t>& newValues) {
+    // Edits made from inside an onBlocksChanged callback don't trigger it again.
+    if (!instance || !hasCallback(OnBlocksChanged) || instance->invokingBlocksChanged)
+        return;
+
+    QJSValueList args{
+        rect.x(), rect.y(), rect.width(), rect.height(), toUint16Array(prevValues), toUint16Array(newValues),
+    };
+    instance->invokingBlocksChanged = true;
+    instance->invokeCallback(OnBlocksChanged, args);
+    instance->invokingBlocksChanged = false;
+}
+
 void Scripting::cb_MapOpened(QString mapName) {
     if (!instance)
         return;
@@ -146,6 +171,31 @@ QJSValue Scripting::fromBlock(Block block) {
     return obj;
 }
 
+QJSValue Scripting::toUint16Array(const QVector<uint16_t>& values) {
+    QByteArray bytes(reinterpret_cast<const char*>(values.constData()), values.length() * static_cast<int>(sizeof(uint16_t)));
+    QJSValue buffer = instance->engine->toScriptValue(bytes);
+    return instance->engine->globalObject().property("Uint16Array").callAsConstructor(QJSValueList{ buffer });
+}
+
+// Accepts a typed array, which is copied directly from its buffer, or a plain array of numbers.
+QVector<uint16_t> Scripting::fromUint16Array(const QJSValue& array, int length) {
+    QVector<uint16_t> values(length, 0);
+    if (array.property("BYTES_PER_ELEMENT").toInt() == static_cast<int>(sizeof(uint16_t))) {
+        QByteArray bytes = array.property("buffer").toVariant().toByteArray();
+        int byteOffset = array.property("byteOffset").toInt();
+        int count = qMin(length, array.property("length").toInt());
+        if (byteOffset >= 0 && byteOffset + count * static_cast<int>(sizeof(uint16_t)) <= bytes.size()) {
+            memcpy(values.data(), bytes.constData() + byteOffset, count * sizeof(uint16_t));
+            return values;
+        }
+    }
+    int count = qMin(length, array.property("length").toInt());
+    for (int i = 0; i < count; i++) {
+        values[i] = static_cast<uint16_t>(array.property(static_cast<quint32>(i)).toUInt());
+    }
+    return values;
+}
+
 QJSValue Scripting::dimensions(int width, int height) {
     QJSValue obj = instance->engine->newObject();
     obj.setProperty("width", width);
@@ -25,21 +25,40 @@ void CityMapPixmapItem::init() {
 }
 
 void CityMapPixmapItem::draw() {
-    QImage image(width_ * 8, height_ * 8, QImage::Format_RGBA8888);
+    QImage image(width_ * 8, height_ * 8, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
 
     QPainter painter(&image);
     for (int i = 0; i < data.size() / 2; i++) {
-        QImage img = this->tile_selector->tileImg(data[i * 2]); // need to skip every other tile
         int x = i % width_;
         int y = i / width_;
-        QPoint pos = QPoint(x * 8, y * 8);
-        painter.drawImage(pos, img);
+        this->tile_selector->paintTile(&painter, QPoint(x * 8, y * 8), static_cast<uint8_t>(data[i * 2])); // need to skip every other tile
     }
     painter.end();
 
     this->setPixmap(QPixmap::fromImage(image));
 }
 
+void CityMapPixmapItem::drawSquare(int index) {
+    if (index < 0 || index * 2 >= data.size())
+        return;
+    if (this->pixmap().size() != QSize(width_ * 8, height_ * 8)) {
+        draw();
+        return;
+    }
+
+    // Release the item's reference first so that painting doesn't copy the whole pixmap.
+    QPixmap pixmap = this->pixmap();
+    this->setPixmap(QPixmap());
+    QPainter painter(&pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    int x = index % width_;
+    int y = index / width_;
+    this->tile_selector->paintTile(&painter, QPoint(x * 8, y * 8), static_cast<uint8_t>(data[index * 2]));
+    painter.end();
+    this->setPixmap(pixmap);
+}
+
 void CityMapPixmapItem::save() {
     QFile binFile(file);
     if (!binFile.open(QIODevice::WriteOnly)) {
@@ -61,7 +80,7 @@ void CityMapPixmapItem::paint(QGraphicsSceneMouseEvent* event) {
     int index = getIndexAt(x, y);
     data[index] = static_cast<uint8_t>(this->tile_selector->selectedTile);
 
-    draw();
+    drawSquare(index / 2);
 }
 
 void CityMapPixmapItem::mousePressEvent(QGraphicsSceneMouseEvent* event) {
@@ -37,15 +37,19 @@ void CollisionPixmapItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
 void CollisionPixmapItem::draw(bool ignoreCache) {
     if (map) {
         map->setCollisionItem(this);
-        setPixmap(map->renderCollision(*this->opacity, ignoreCache));
+        updateChunks(map->takeDirtyCollisionRect(), ignoreCache);
     }
 }
 
+void CollisionPixmapItem::paintBlocks(QPainter* painter, const QRect& blockRect) {
+    map->paintCollisionBlocks(painter, blockRect, *this->opacity);
+}
+
 void CollisionPixmapItem::paint(QGraphicsSceneMouseEvent* event) {
     if (event->type() == QEvent::GraphicsSceneMouseRelease) {
         actionId_++;
     } else if (map) {
-        Blockdata oldCollision = map->layout->blockdata;
+        BlockdataDiff changes;
 
         QPoint pos = Metatile::coordFromPixmapCoord(event->pos());
 
@@ -62,11 +66,12 @@ void CollisionPixmapItem::paint(QGraphicsSceneMouseEvent* event) {
         if (map->getBlock(pos.x(), pos.y(), &block)) {
             block.collision = this->movementPermissionsSelector->getSelectedCollision();
             block.elevation = this->movementPermissionsSelector->getSelectedElevation();
-            map->setBlock(pos.x(), pos.y(), block, true);
+            map->setBlock(pos.x(), pos.y(), block, true, &changes);
         }
 
-        if (map->layout->blockdata != oldCollision) {
-            map->editHistory.push(new PaintCollision(map, oldCollision, map->layout->blockdata, actionId_));
+        changes.compact();
+        if (!changes.isEmpty()) {
+            map->editHistory.push(new PaintCollision(map, changes, actionId_));
         }
     }
 }
@@ -75,15 +80,16 @@ void CollisionPixmapItem::floodFill(QGraphicsSceneMouseEvent* event) {
     if (event->type() == QEvent::GraphicsSceneMouseRelease) {
         this->actionId_++;
     } else if (map) {
-        Blockdata oldCollision = map->layout->blockdata;
+        BlockdataDiff changes;
 
         QPoint pos = Metatile::coordFromPixmapCoord(event->pos());
         uint16_t collision = this->movementPermissionsSelector->getSelectedCollision();
         uint16_t elevation = this->movementPermissionsSelector->getSelectedElevation();
-        map->floodFillCollisionElevation(pos.x(), pos.y(), collision, elevation);
+        map->floodFillCollisionElevation(pos.x(), pos.y(), collision, elevation, &changes);
 
-        if (map->layout->blockdata != oldCollision) {
-            map->editHistory.push(new BucketFillCollision(map, oldCollision, map->layout->blockdata));
+        changes.compact();
+        if (!changes.isEmpty()) {
+            map->editHistory.push(new BucketFillCollision(map, changes));
         }
     }
 }
@@ -92,14 +98,15 @@ void CollisionPixmapItem::magicFill(QGraphicsSceneMouseEvent* event) {
     if (event->type() == QEvent::GraphicsSceneMouseRelease) {
         this->actionId_++;
     } else if (map) {
-        Blockdata oldCollision = map->layout->blockdata;
+        BlockdataDiff changes;
         QPoint pos = Metatile::coordFromPixmapCoord(event->pos());
         uint16_t collision = this->movementPermissionsSelector->getSelectedCollision();
         uint16_t elevation = this->movementPermissionsSelector->getSelectedElevation();
-        map->magicFillCollisionElevation(pos.x(), pos.y(), collision, elevation);
+        map->magicFillCollisionElevation(pos.x(), pos.y(), collision, elevation, &changes);
 
-        if (map->layout->blockdata != oldCollision) {
-            map->editHistory.push(new MagicFillCollision(map, oldCollision, map->layout->blockdata));
+        changes.compact();
+        if (!changes.isEmpty()) {
+            map->editHistory.push(new MagicFillCollision(map, changes));
         }
     }
 }
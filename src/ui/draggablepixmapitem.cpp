@@ -34,15 +34,17 @@ void DraggablePixmapItem::updatePixmap() {
     emit spriteChanged(event->pixmap);
 }
 
-void DraggablePixmapItem::bind(QComboBox* combo, QString key) {
-    connect(combo, static_cast<void (QComboBox::*)(const QString&)>(&QComboBox::currentTextChanged), this,
+QList<QMetaObject::Connection> DraggablePixmapItem::bind(QComboBox* combo, QString key) {
+    QList<QMetaObject::Connection> connections;
+    connections << connect(combo, static_cast<void (QComboBox::*)(const QString&)>(&QComboBox::currentTextChanged), this,
         [this, key](QString value) { this->event->put(key, value); });
-    connect(this, &DraggablePixmapItem::onPropertyChanged, this, [combo, key](QString key2, QString value) {
+    // The combo box may be using one of the project's shared list models, so the value is only shown in its line edit.
+    connections << connect(this, &DraggablePixmapItem::onPropertyChanged, combo, [combo, key](QString key2, QString value) {
         if (key2 == key) {
-            combo->addItem(value);
             combo->setCurrentText(value);
         }
     });
+    return connections;
 }
 
 void DraggablePixmapItem::bindToUserData(QComboBox* combo, QString key) {
@@ -92,12 +94,12 @@ void DraggablePixmapItem::mouseReleaseEvent(QGraphicsSceneMouseEvent*) {
 }
 
 void DraggablePixmapItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent*) {
-    if (this->event->get("event_type") == EventType::Warp) {
+    if (this->event->kind() == Event::Kind::Warp) {
         QString destMap = this->event->get("destination_map_name");
         if (destMap != NONE_MAP_NAME) {
             emit editor->warpEventDoubleClicked(this->event->get("destination_map_name"), this->event->get("destination_warp"));
         }
-    } else if (this->event->get("event_type") == EventType::SecretBase) {
+    } else if (this->event->kind() == Event::Kind::SecretBase) {
         QString baseId = this->event->get("secret_base_id");
         QString destMap = editor->project->mapConstantsToMapNames.value("MAP_" + baseId.left(baseId.lastIndexOf("_")));
         if (destMap != NONE_MAP_NAME) {
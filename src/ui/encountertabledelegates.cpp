@@ -0,0 +1,55 @@
+#include "encountertabledelegates.h"
+#include "noscrollcombobox.h"
+#include "noscrollspinbox.h"
+
+SpeciesComboDelegate::SpeciesComboDelegate(QAbstractItemModel* speciesModel, QObject* parent) : QStyledItemDelegate(parent) {
+    this->speciesModel = speciesModel;
+}
+
+QWidget* SpeciesComboDelegate::createEditor(QWidget* parent, const QStyleOptionViewItem&, const QModelIndex&) const {
+    NoScrollComboBox* combo = new NoScrollComboBox(parent);
+    combo->setEditable(true);
+    combo->setModel(this->speciesModel);
+    // The species list is shared, so typed species aren't added to it.
+    combo->setInsertPolicy(QComboBox::NoInsert);
+    // Commit as soon as a species is picked, rather than when the editor closes.
+    connect(combo, QOverload<int>::of(&QComboBox::activated), this, [this, combo](int) {
+        emit const_cast<SpeciesComboDelegate*>(this)->commitData(combo);
+    });
+    return combo;
+}
+
+void SpeciesComboDelegate::setEditorData(QWidget* editor, const QModelIndex& index) const {
+    NoScrollComboBox* combo = static_cast<NoScrollComboBox*>(editor);
+    QString species = index.data(Qt::EditRole).toString();
+    combo->setCurrentIndex(combo->findText(species));
+    combo->setCurrentText(species);
+}
+
+void SpeciesComboDelegate::setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const {
+    NoScrollComboBox* combo = static_cast<NoScrollComboBox*>(editor);
+    model->setData(index, combo->currentText(), Qt::EditRole);
+}
+
+SpinBoxDelegate::SpinBoxDelegate(int min, int max, QObject* parent) : QStyledItemDelegate(parent) {
+    this->min = min;
+    this->max = max;
+}
+
+QWidget* SpinBoxDelegate::createEditor(QWidget* parent, const QStyleOptionViewItem&, const QModelIndex&) const {
+    NoScrollSpinBox* spinBox = new NoScrollSpinBox(parent);
+    spinBox->setMinimum(this->min);
+    spinBox->setMaximum(this->max);
+    return spinBox;
+}
+
+void SpinBoxDelegate::setEditorData(QWidget* editor, const QModelIndex& index) const {
+    NoScrollSpinBox* spinBox = static_cast<NoScrollSpinBox*>(editor);
+    spinBox->setValue(index.data(Qt::EditRole).toInt());
+}
+
+void SpinBoxDelegate::setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const {
+    NoScrollSpinBox* spinBox = static_cast<NoScrollSpinBox*>(editor);
+    spinBox->interpretText();
+    model->setData(index, spinBox->value(), Qt::EditRole);
+}
@@ -0,0 +1,170 @@
+#include "encountertablemodel.h"
+#include "project.h"
+
+EncounterTableModel::EncounterTableModel(WildMonInfo monInfo, EncounterField monField, Project* project, QObject* parent)
+    : QAbstractTableModel(parent) {
+    this->monInfo = monInfo;
+    this->monInfo.active = true;
+    this->monField = monField;
+    this->project = project;
+
+    for (int slot = 0; slot < monInfo.wildPokemon.length(); slot++) {
+        QString groupName;
+        double slotChanceTotal = 0.0;
+        if (!monField.groups.isEmpty()) {
+            for (QString groupKey : monField.groups.keys()) {
+                if (monField.groups[groupKey].contains(slot)) {
+                    groupName = groupKey;
+                    for (int chanceIndex : monField.groups[groupKey]) {
+                        slotChanceTotal += static_cast<double>(monField.encounterRates.value(chanceIndex));
+                    }
+                    break;
+                }
+            }
+        } else {
+            for (auto chance : monField.encounterRates) {
+                slotChanceTotal += static_cast<double>(chance);
+            }
+        }
+        this->groupNames.append(groupName);
+        this->slotPercentages.append(slotChanceTotal > 0.0 ? monField.encounterRates.value(slot) / slotChanceTotal * 100.0 : 0.0);
+    }
+}
+
+int EncounterTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : this->monInfo.wildPokemon.length();
+}
+
+int EncounterTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : Column::Count;
+}
+
+QVariant EncounterTableModel::data(const QModelIndex& index, int role) const {
+    int row = index.row();
+    if (!index.isValid() || row >= this->monInfo.wildPokemon.length())
+        return QVariant();
+
+    const WildPokemon& mon = this->monInfo.wildPokemon.at(row);
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        switch (index.column()) {
+        case Column::Slot:
+            return QString("%1.").arg(row);
+        case Column::Group:
+            return this->groupNames.value(row);
+        case Column::Species:
+            return mon.species;
+        case Column::MinLevel:
+            return mon.minLevel;
+        case Column::MaxLevel:
+            return mon.maxLevel;
+        case Column::EncounterChance:
+            return QString("%1%").arg(QString::number(this->slotPercentages.value(row), 'f', 2));
+        case Column::SlotRatio:
+            return this->monField.encounterRates.value(row);
+        case Column::EncounterRate:
+            // The encounter rate is shared by every slot, so it's only shown once.
+            if (row == 0)
+                return this->monInfo.encounterRate;
+            break;
+        }
+    } else if (role == Qt::DecorationRole && index.column() == Column::Species) {
+        return this->project->getSpeciesIcon(mon.species);
+    }
+    return QVariant();
+}
+
+QVariant EncounterTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return QVariant();
+
+    switch (section) {
+    case Column::Slot:
+        return "Slot";
+    case Column::Group:
+        return "Group";
+    case Column::Species:
+        return "Species";
+    case Column::MinLevel:
+        return "Min Level";
+    case Column::MaxLevel:
+        return "Max Level";
+    case Column::EncounterChance:
+        return "Encounter Chance";
+    case Column::SlotRatio:
+        return "Slot Ratio";
+    case Column::EncounterRate:
+        return "Encounter Rate";
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags EncounterTableModel::flags(const QModelIndex& index) const {
+    Qt::ItemFlags flags = QAbstractTableModel::flags(index);
+    switch (index.column()) {
+    case Column::Species:
+    case Column::MinLevel:
+    case Column::MaxLevel:
+        flags |= Qt::ItemIsEditable;
+        break;
+    case Column::EncounterRate:
+        if (index.row() == 0)
+            flags |= Qt::ItemIsEditable;
+        break;
+    }
+    return flags;
+}
+
+bool EncounterTableModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+    int row = index.row();
+    if (!index.isValid() || role != Qt::EditRole || row >= this->monInfo.wildPokemon.length())
+        return false;
+
+    WildPokemon& mon = this->monInfo.wildPokemon[row];
+    switch (index.column()) {
+    case Column::Species: {
+        QString species = value.toString();
+        // Only species with an icon are known to the project.
+        if (species == mon.species || !this->project->speciesToIconPath.contains(species))
+            return false;
+        mon.species = species;
+        emit dataChanged(index, index);
+        return true;
+    }
+    case Column::MinLevel: {
+        int minLevel = value.toInt();
+        if (minLevel == mon.minLevel)
+            return false;
+        mon.minLevel = minLevel;
+        // The max level is never less than the min level.
+        if (mon.maxLevel < minLevel)
+            mon.maxLevel = minLevel;
+        emit dataChanged(index, this->index(row, Column::MaxLevel));
+        return true;
+    }
+    case Column::MaxLevel: {
+        int maxLevel = qMax(value.toInt(), mon.minLevel);
+        if (maxLevel == mon.maxLevel)
+            return false;
+        mon.maxLevel = maxLevel;
+        emit dataChanged(index, index);
+        return true;
+    }
+    case Column::EncounterRate: {
+        int encounterRate = value.toInt();
+        if (row != 0 || encounterRate == this->monInfo.encounterRate)
+            return false;
+        this->monInfo.encounterRate = encounterRate;
+        emit dataChanged(index, index);
+        return true;
+    }
+    }
+    return false;
+}
+
+WildMonInfo EncounterTableModel::encounterData() const {
+    return this->monInfo;
+}
+
+bool EncounterTableModel::hasGroups() const {
+    return !this->monField.groups.isEmpty();
+}
@@ -3,9 +3,9 @@
 
 #include "ui_eventpropertiesframe.h"
 
-EventPropertiesFrame::EventPropertiesFrame(Event* event, QWidget* parent) : QFrame(parent), ui(new Ui::EventPropertiesFrame) {
+EventPropertiesFrame::EventPropertiesFrame(QString eventType, QWidget* parent) : QFrame(parent), ui(new Ui::EventPropertiesFrame) {
     ui->setupUi(this);
-    this->event = event;
+    this->eventType = eventType;
     this->firstShow = true;
 }
 
@@ -13,11 +13,27 @@ EventPropertiesFrame::~EventPropertiesFrame() {
     delete ui;
 }
 
+void EventPropertiesFrame::setEvent(Event* event) {
+    this->event = event;
+    // The custom attributes table is rebuilt for the new event the next time the frame is drawn.
+    if (this->customAttributes) {
+        delete this->customAttributes;
+        this->customAttributes = nullptr;
+    }
+    this->firstShow = true;
+}
+
+void EventPropertiesFrame::unbind() {
+    for (auto connection : this->connections)
+        disconnect(connection);
+    this->connections.clear();
+}
+
 void EventPropertiesFrame::paintEvent(QPaintEvent* painter) {
     // Custom fields table.
-    if (firstShow && event->get("event_type") != EventType::HealLocation) {
-        CustomAttributesTable* customAttributes = new CustomAttributesTable(event, this);
-        this->layout()->addWidget(customAttributes);
+    if (firstShow && event && event->get("event_type") != EventType::HealLocation) {
+        this->customAttributes = new CustomAttributesTable(event, this);
+        this->layout()->addWidget(this->customAttributes);
     }
     QFrame::paintEvent(painter);
     firstShow = false;
@@ -16,10 +16,8 @@ void GraphicsView::mouseReleaseEvent(QMouseEvent* event) {
     QGraphicsView::mouseReleaseEvent(event);
 }
 
-void GraphicsView::drawForeground(QPainter* painter, const QRectF&) {
-    for (auto item : this->overlay.getItems()) {
-        item->render(painter);
-    }
+void GraphicsView::drawForeground(QPainter* painter, const QRectF& rect) {
+    this->overlay.render(painter, rect);
 }
 
 void GraphicsView::moveEvent(QMoveEvent* event) {
@@ -2,20 +2,119 @@
 #include "imageproviders.h"
 #include "log.h"
 #include <QPainter>
+#include <QCache>
+#include <QMutex>
+#include <cstring>
+
+// Metatile images are shared by every renderer (map, collision, border, connections, selectors).
+// Entries are keyed by the revisions of the tilesets they were built from, so editing a tileset's
+// palettes or metatiles (see Tileset::markChanged) makes its old entries unreachable.
+struct MetatileImageKey {
+    uint16_t metatileId;
+    quint64 primaryRevision;
+    quint64 secondaryRevision;
+    QList<int> layerOrder;
+    QList<float> layerOpacity;
+    bool useTruePalettes;
+
+    bool operator==(const MetatileImageKey& other) const {
+        return metatileId == other.metatileId && primaryRevision == other.primaryRevision && secondaryRevision == other.secondaryRevision
+            && layerOrder == other.layerOrder && layerOpacity == other.layerOpacity && useTruePalettes == other.useTruePalettes;
+    }
+};
+
+inline uint qHash(const MetatileImageKey& key, uint seed = 0) {
+    uint hash = seed ^ key.metatileId;
+    hash = 31 * hash + qHash(key.primaryRevision);
+    hash = 31 * hash + qHash(key.secondaryRevision);
+    hash = 31 * hash + qHash(key.layerOrder);
+    hash = 31 * hash + qHash(key.layerOpacity);
+    return hash ^ static_cast<uint>(key.useTruePalettes);
+}
+
+// Enough room for every metatile of several primary/secondary tileset pairs.
+static const int maxCachedMetatileImages = 16384;
+static QCache<MetatileImageKey, QImage> metatileImageCache(maxCachedMetatileImages);
+static QMutex metatileImageCacheMutex;
+
+static QImage buildMetatileImage(uint16_t, Tileset*, Tileset*, const QList<int>&, const QList<float>&, bool);
+
+void clearMetatileImageCache() {
+    QMutexLocker locker(&metatileImageCacheMutex);
+    metatileImageCache.clear();
+}
 
 QImage getCollisionMetatileImage(Block block) {
     return getCollisionMetatileImage(block.collision, block.elevation);
 }
 
 QImage getCollisionMetatileImage(int collision, int elevation) {
+    // Loaded once as a QImage (rather than a QPixmap) so collision can also be drawn off the GUI thread.
+    static const QImage collisionsImage(":/images/collisions.png");
     int x = collision * 16;
     int y = elevation * 16;
-    QPixmap collisionImage = QPixmap(":/images/collisions.png").copy(x, y, 16, 16);
-    return collisionImage.toImage();
+    return collisionsImage.copy(x, y, 16, 16);
 }
 
 QImage getMetatileImage(
     uint16_t tile, Tileset* primaryTileset, Tileset* secondaryTileset, QList<int> layerOrder, QList<float> layerOpacity, bool useTruePalettes) {
+    MetatileImageKey key{ tile, primaryTileset ? primaryTileset->revision() : 0, secondaryTileset ? secondaryTileset->revision() : 0, layerOrder,
+        layerOpacity, useTruePalettes };
+
+    QMutexLocker locker(&metatileImageCacheMutex);
+    if (QImage* cached = metatileImageCache.object(key)) {
+        return *cached;
+    }
+    locker.unlock();
+
+    QImage metatile_image = buildMetatileImage(tile, primaryTileset, secondaryTileset, layerOrder, layerOpacity, useTruePalettes);
+
+    locker.relock();
+    metatileImageCache.insert(key, new QImage(metatile_image));
+    return metatile_image;
+}
+
+// Blends an 8x8 tile into the RGBA8888 metatile pixels at 'dest', looking up each pixel's palette index in 'colors'.
+// Colors with an alpha below 255 (translucent layers, or the transparent color 0 of upper layers) are blended over
+// what has already been drawn, like QPainter's default composition mode.
+static void blendTile(uchar* dest, int bytesPerLine, const uchar* pixels, const QRgb* colors, int numColors, bool xflip, bool yflip) {
+    for (int py = 0; py < 8; py++) {
+        const uchar* src = pixels + (yflip ? 7 - py : py) * 8;
+        uchar* out = dest + py * bytesPerLine;
+        for (int px = 0; px < 8; px++, out += 4) {
+            uchar index = src[xflip ? 7 - px : px];
+            QRgb color = index < numColors ? colors[index] : qRgb(0, 0, 0);
+            int alpha = qAlpha(color);
+            if (alpha == 255) {
+                out[0] = static_cast<uchar>(qRed(color));
+                out[1] = static_cast<uchar>(qGreen(color));
+                out[2] = static_cast<uchar>(qBlue(color));
+                out[3] = 255;
+            } else if (alpha != 0) {
+                int inverse = 255 - alpha;
+                out[0] = static_cast<uchar>((qRed(color) * alpha + out[0] * inverse + 127) / 255);
+                out[1] = static_cast<uchar>((qGreen(color) * alpha + out[1] * inverse + 127) / 255);
+                out[2] = static_cast<uchar>((qBlue(color) * alpha + out[2] * inverse + 127) / 255);
+                out[3] = static_cast<uchar>(alpha + (out[3] * inverse + 127) / 255);
+            }
+        }
+    }
+}
+
+static void fillTile(uchar* dest, int bytesPerLine, QRgb color) {
+    for (int py = 0; py < 8; py++) {
+        uchar* out = dest + py * bytesPerLine;
+        for (int px = 0; px < 8; px++, out += 4) {
+            out[0] = static_cast<uchar>(qRed(color));
+            out[1] = static_cast<uchar>(qGreen(color));
+            out[2] = static_cast<uchar>(qBlue(color));
+            out[3] = 255;
+        }
+    }
+}
+
+static QImage buildMetatileImage(uint16_t tile, Tileset* primaryTileset, Tileset* secondaryTileset, const QList<int>& layerOrder,
+    const QList<float>& layerOpacity, bool useTruePalettes) {
     QImage metatile_image(16, 16, QImage::Format_RGBA8888);
     metatile_image.fill(Qt::black);
 
@@ -32,58 +131,64 @@ QImage getMetatileImage(
     }
     QList<QList<QRgb>> palettes = Tileset::getBlockPalettes(primaryTileset, secondaryTileset, useTruePalettes);
 
-    QPainter metatile_painter(&metatile_image);
+    uchar* bits = metatile_image.bits();
+    int bytesPerLine = metatile_image.bytesPerLine();
     bool isTripleLayerMetatile = projectConfig.getTripleLayerMetatilesEnabled();
     int numLayers = isTripleLayerMetatile ? 3 : 2;
+    int bottomLayer = layerOrder.size() >= numLayers ? layerOrder[0] : 0;
+    QRgb colors[256];
     for (int layer = 0; layer < numLayers; layer++)
         for (int y = 0; y < 2; y++)
             for (int x = 0; x < 2; x++) {
                 int l = layerOrder.size() >= numLayers ? layerOrder[layer] : layer;
-                int bottomLayer = layerOrder.size() >= numLayers ? layerOrder[0] : 0;
                 Tile tile_ = metatile->tiles.value((y * 2) + x + (l * 4));
-                QImage tile_image = getTileImage(tile_.tile, primaryTileset, secondaryTileset);
-                if (tile_image.isNull()) {
+                uchar* dest = bits + (y * 8) * bytesPerLine + (x * 8) * 4;
+
+                Tileset* tileTileset = Tileset::getBlockTileset(tile_.tile, primaryTileset, secondaryTileset);
+                const uchar* pixels = tileTileset ? tileTileset->getTilePixels(Metatile::getBlockIndex(tile_.tile)) : nullptr;
+                if (!pixels) {
                     // Some metatiles specify tiles that are outside the valid range.
                     // These are treated as completely transparent, so they can be skipped without
                     // being drawn unless they're on the bottom layer, in which case we need
                     // a placeholder because garbage will be drawn otherwise.
                     if (l == bottomLayer) {
-                        metatile_painter.fillRect(x * 8, y * 8, 8, 8, palettes.value(0).value(0));
+                        fillTile(dest, bytesPerLine, palettes.value(0).value(0));
                     }
                     continue;
                 }
 
                 // Colorize the metatile tiles with its palette.
+                // Colors the palette doesn't cover keep the tiles image's own colors.
+                const QVector<QRgb> imageColors = tileTileset->tilesImage.colorTable();
+                int numColors = imageColors.size();
+                for (int j = 0; j < numColors; j++) {
+                    colors[j] = imageColors.at(j);
+                }
                 if (tile_.palette < palettes.length()) {
-                    QList<QRgb> palette = palettes.value(tile_.palette);
+                    const QList<QRgb>& palette = palettes.at(tile_.palette);
+                    numColors = qMax(numColors, palette.length());
                     for (int j = 0; j < palette.length(); j++) {
-                        tile_image.setColor(j, palette.value(j));
+                        colors[j] = palette.at(j);
                     }
                 } else {
                     logWarn(QString("Tile '%1' is referring to invalid palette number: '%2'").arg(tile_.tile).arg(tile_.palette));
                 }
 
-                QPoint origin = QPoint(x * 8, y * 8);
                 float opacity = layerOpacity.size() >= numLayers ? layerOpacity[l] : 1.0;
                 if (opacity < 1.0) {
                     int alpha = 255 * opacity;
-                    for (int c = 0; c < tile_image.colorCount(); c++) {
-                        QColor color(tile_image.color(c));
-                        color.setAlpha(alpha);
-                        tile_image.setColor(c, color.rgba());
+                    for (int c = 0; c < numColors; c++) {
+                        colors[c] = qRgba(qRed(colors[c]), qGreen(colors[c]), qBlue(colors[c]), alpha);
                     }
                 }
 
                 // The top layer of the metatile has its first color displayed at transparent.
-                if (l != bottomLayer) {
-                    QColor color(tile_image.color(0));
-                    color.setAlpha(0);
-                    tile_image.setColor(0, color.rgba());
+                if (l != bottomLayer && numColors > 0) {
+                    colors[0] = qRgba(qRed(colors[0]), qGreen(colors[0]), qBlue(colors[0]), 0);
                 }
 
-                metatile_painter.drawImage(origin, tile_image.mirrored(tile_.xflip, tile_.yflip));
+                blendTile(dest, bytesPerLine, pixels, colors, numColors, tile_.xflip, tile_.yflip);
             }
-    metatile_painter.end();
 
     return metatile_image;
 }
@@ -94,7 +199,17 @@ QImage getTileImage(uint16_t tile, Tileset* primaryTileset, Tileset* secondaryTi
     if (!tileset) {
         return QImage();
     }
-    return tileset->tiles.value(local_index, QImage());
+    const uchar* pixels = tileset->getTilePixels(local_index);
+    if (!pixels) {
+        return QImage();
+    }
+
+    QImage tileImage(8, 8, QImage::Format_Indexed8);
+    tileImage.setColorTable(tileset->tilesImage.colorTable());
+    for (int y = 0; y < 8; y++) {
+        memcpy(tileImage.scanLine(y), pixels + y * 8, 8);
+    }
+    return tileImage;
 }
 
 QImage getColoredTileImage(uint16_t tile, Tileset* primaryTileset, Tileset* secondaryTileset, QList<QRgb> palette) {
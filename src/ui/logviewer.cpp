@@ -0,0 +1,38 @@
+#include "logviewer.h"
+#include "log.h"
+
+#include <QVBoxLayout>
+#include <QFontDatabase>
+#include <QScrollBar>
+
+LogViewer::LogViewer(QWidget* parent) : QDialog(parent) {
+    setWindowTitle("Porymap Log");
+    setAttribute(Qt::WA_DeleteOnClose);
+    resize(800, 400);
+
+    this->textEdit = new QPlainTextEdit(this);
+    this->textEdit->setReadOnly(true);
+    this->textEdit->setLineWrapMode(QPlainTextEdit::NoWrap);
+    this->textEdit->setMaximumBlockCount(5000);
+    this->textEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    auto* layout = new QVBoxLayout(this);
+    layout->addWidget(this->textEdit);
+
+    this->appendNewLines();
+    connect(&this->refreshTimer, &QTimer::timeout, this, &LogViewer::appendNewLines);
+    this->refreshTimer.start(250);
+}
+
+void LogViewer::appendNewLines() {
+    QStringList lines = getRecentLogLines(&this->linesSeen);
+    if (lines.isEmpty())
+        return;
+
+    // Only follow new messages if the view is already scrolled to the bottom.
+    QScrollBar* scrollBar = this->textEdit->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+    this->textEdit->appendPlainText(lines.join('\n'));
+    if (atBottom)
+        scrollBar->setValue(scrollBar->maximum());
+}
@@ -1,16 +1,24 @@
 #include "mapimageexporter.h"
 #include "ui_mapimageexporter.h"
-#include "qgifimage.h"
+#include "gifwriter.h"
 #include "editcommands.h"
+#include "log.h"
 
 #include <QFileDialog>
+#include <QFile>
+#include <QSet>
 #include <QMatrix>
 #include <QImage>
 #include <QPainter>
 #include <QPoint>
+#include <QtConcurrent>
+#include <QFutureWatcher>
+#include <QEventLoop>
 
 #define STITCH_MODE_BORDER_DISTANCE 2
 
+static void drawGrid(QPainter* painter, const QRect& rect);
+
 QString getTitle(ImageExporterMode mode) {
     switch (mode) {
     case ImageExporterMode::Normal:
@@ -44,6 +52,22 @@ MapImageExporter::~MapImageExporter() {
     delete ui;
 }
 
+// Whether the command only changes the map's blocks, which are tracked by Map::takeChangedBlocksRect().
+static bool isBlockEditCommand(const QUndoCommand* command) {
+    switch (command->id() & 0xFF) {
+    case CommandId::ID_PaintMetatile:
+    case CommandId::ID_BucketFillMetatile:
+    case CommandId::ID_MagicFillMetatile:
+    case CommandId::ID_ShiftMetatiles:
+    case CommandId::ID_PaintCollision:
+    case CommandId::ID_BucketFillCollision:
+    case CommandId::ID_MagicFillCollision:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void MapImageExporter::saveImage() {
     QString title = getTitle(this->mode);
     QString defaultFilename;
@@ -73,16 +97,16 @@ void MapImageExporter::saveImage() {
             progress.setAutoClose(true);
             progress.setWindowModality(Qt::WindowModal);
             progress.setModal(true);
-            QPixmap pixmap = this->getStitchedImage(&progress, this->showBorder);
-            if (progress.wasCanceled()) {
+            QImage image = this->getStitchedImage(&progress, this->showBorder);
+            if (progress.wasCanceled() || image.isNull()) {
                 progress.close();
                 return;
             }
-            pixmap.save(filepath);
+            image.save(filepath);
             progress.close();
             break;
         }
-        case ImageExporterMode::Timelapse:
+        case ImageExporterMode::Timelapse: {
             QProgressDialog progress("Building map timelapse...", "Cancel", 0, 1, this);
             progress.setAutoClose(true);
             progress.setWindowModality(Qt::WindowModal);
@@ -115,51 +139,66 @@ void MapImageExporter::saveImage() {
                 }
                 i++;
             }
-            QGifImage timelapseImg(QSize(maxWidth, maxHeight));
-            timelapseImg.setDefaultDelay(timelapseDelayMs);
-            timelapseImg.setDefaultTransparentColor(QColor(0, 0, 0));
+            // Frames are written to disk as they're drawn. After the first frame, only the blocks
+            // changed by the edits in between are redrawn and written, unless an edit that can't
+            // be narrowed down to blocks (events, border, resizing) was made.
+            bool fullRedraw = true;
+            auto redoNext = [&]() {
+                i--;
+                this->map->editHistory.redo();
+                if (!isBlockEditCommand(this->map->editHistory.command(this->map->editHistory.index() - 1)))
+                    fullRedraw = true;
+            };
+            QImage frame(maxWidth, maxHeight, QImage::Format_RGB32);
+            QRect changedRect = this->drawTimelapseFrame(&frame, fullRedraw);
+            fullRedraw = false;
+
+            GifWriter timelapseGif;
+            bool success = timelapseGif.open(filepath, frame.size(), this->getTimelapseColorTable(frame));
             // Draw each frame, skpping the specified number of map edits in
             // the undo history.
             progress.setMaximum(i);
-            while (i > 0) {
+            bool firstFrame = true;
+            while (success && i > 0) {
                 if (progress.wasCanceled()) {
-                    progress.close();
-                    while (i > 0 && this->map->editHistory.canRedo()) {
-                        i--;
-                        this->map->editHistory.redo();
-                    }
-                    return;
+                    break;
                 }
                 while (this->map->editHistory.canRedo() && !historyItemAppliesToFrame(this->map->editHistory.command(this->map->editHistory.index()))) {
-                    i--;
-                    this->map->editHistory.redo();
+                    redoNext();
                 }
                 progress.setValue(progress.maximum() - i);
-                QPixmap pixmap = this->getFormattedMapPixmap(this->map, !this->showBorder);
-                if (pixmap.width() < maxWidth || pixmap.height() < maxHeight) {
-                    QPixmap pixmap2 = QPixmap(maxWidth, maxHeight);
-                    QPainter painter(&pixmap2);
-                    pixmap2.fill(QColor(0, 0, 0));
-                    painter.drawPixmap(0, 0, pixmap.width(), pixmap.height(), pixmap);
-                    painter.end();
-                    pixmap = pixmap2;
+                if (!firstFrame) {
+                    changedRect = this->drawTimelapseFrame(&frame, fullRedraw);
+                    fullRedraw = false;
                 }
-                timelapseImg.addFrame(pixmap.toImage());
+                firstFrame = false;
+                success = timelapseGif.writeFrame(frame, changedRect, timelapseDelayMs);
                 for (int j = 0; j < timelapseSkipAmount; j++) {
                     if (i > 0) {
-                        i--;
-                        this->map->editHistory.redo();
+                        redoNext();
                         while (this->map->editHistory.canRedo() && !historyItemAppliesToFrame(this->map->editHistory.command(this->map->editHistory.index()))) {
-                            i--;
-                            this->map->editHistory.redo();
+                            redoNext();
                         }
                     }
                 }
             }
-            // The latest map state is the last animated frame.
-            QPixmap pixmap = this->getFormattedMapPixmap(this->map, !this->showBorder);
-            timelapseImg.addFrame(pixmap.toImage());
-            timelapseImg.save(filepath);
+            if (success && !progress.wasCanceled()) {
+                // The latest map state is the last animated frame.
+                changedRect = this->drawTimelapseFrame(&frame, fullRedraw || firstFrame);
+                success = timelapseGif.writeFrame(frame, changedRect, timelapseDelayMs) && timelapseGif.close();
+            }
+            if (!success || progress.wasCanceled()) {
+                if (!success)
+                    logError(QString("Failed to export map timelapse: %1").arg(timelapseGif.errorString()));
+                timelapseGif.close();
+                QFile::remove(filepath);
+                while (i > 0 && this->map->editHistory.canRedo()) {
+                    i--;
+                    this->map->editHistory.redo();
+                }
+                progress.close();
+                return;
+            }
             progress.close();
             break;
         }
@@ -197,24 +236,119 @@ bool MapImageExporter::historyItemAppliesToFrame(const QUndoCommand* command) {
     }
 }
 
+// Draws the next timelapse frame over the previous one, and returns the area of the frame that changed.
+QRect MapImageExporter::drawTimelapseFrame(QImage* frame, bool fullRedraw) {
+    QRect changedBlocks = this->map->takeChangedBlocksRect();
+    QPainter painter(frame);
+    if (fullRedraw) {
+        frame->fill(Qt::black);
+        painter.drawPixmap(0, 0, this->getFormattedMapPixmap(this->map, !this->showBorder));
+        return frame->rect();
+    }
+    if (changedBlocks.isEmpty()) {
+        return QRect();
+    }
+
+    // The extra pixel covers the grid line after the last changed block.
+    int borderSize = this->showBorder ? STITCH_MODE_BORDER_DISTANCE * 16 : 0;
+    QRect pixelRect(changedBlocks.x() * 16 + borderSize, changedBlocks.y() * 16 + borderSize, changedBlocks.width() * 16 + 1,
+        changedBlocks.height() * 16 + 1);
+    painter.setClipRect(pixelRect & frame->rect());
+    painter.translate(borderSize, borderSize);
+    if (this->showCollision) {
+        this->map->paintCollisionBlocks(&painter, changedBlocks, this->editor->collisionOpacity);
+    } else {
+        this->map->paintBlocks(&painter, changedBlocks);
+    }
+    this->paintEvents(&painter, this->map);
+    painter.resetTransform();
+    if (this->showGrid) {
+        drawGrid(&painter, pixelRect);
+    }
+    return pixelRect & frame->rect();
+}
+
+// The timelapse uses one color table for every frame, made of the tileset palettes followed by
+// any other colors in the first frame (e.g. event sprites). Later colors use the nearest match.
+QVector<QRgb> MapImageExporter::getTimelapseColorTable(const QImage& firstFrame) {
+    QVector<QRgb> colorTable;
+    QSet<QRgb> added;
+    auto addColor = [&](QRgb color) {
+        color |= 0xFF000000;
+        if (colorTable.length() < 256 && !added.contains(color)) {
+            added.insert(color);
+            colorTable.append(color);
+        }
+    };
+
+    addColor(qRgb(0, 0, 0));
+    if (this->map->layout->tileset_primary && this->map->layout->tileset_secondary) {
+        for (const QList<QRgb>& palette : Tileset::getBlockPalettes(this->map->layout->tileset_primary, this->map->layout->tileset_secondary)) {
+            for (QRgb color : palette)
+                addColor(color);
+        }
+    }
+    QImage image = firstFrame.convertToFormat(QImage::Format_RGB32);
+    for (int y = 0; y < image.height() && colorTable.length() < 256; y++) {
+        const QRgb* pixels = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        for (int x = 0; x < image.width(); x++)
+            addColor(pixels[x]);
+    }
+    return colorTable;
+}
+
 struct StitchedMap {
     int x;
     int y;
     Map* map;
+    // Gathered on the GUI thread, since event pixmaps can't be used on the worker threads that render the map.
+    QList<QPair<QPoint, QImage>> events;
+    QImage image;
 };
 
-QPixmap MapImageExporter::getStitchedImage(QProgressDialog* progress, bool includeBorder) {
+// Rows of the stitched image are composited this many pixels at a time. Rendered maps are released
+// once the bands below them have been drawn, so only the maps near the current band are kept in memory.
+static const int stitchBandHeight = 32 * 16;
+
+static QImage renderStitchedMap(const StitchedMap& stitched, bool showCollision, qreal collisionOpacity) {
+    Map* map = stitched.map;
+    QImage image(map->getWidth() * 16, map->getHeight() * 16, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    QRect blockRect(0, 0, map->getWidth(), map->getHeight());
+    if (showCollision) {
+        map->paintCollisionBlocks(&painter, blockRect, collisionOpacity);
+    } else {
+        map->paintBlocks(&painter, blockRect);
+    }
+    for (auto event : stitched.events) {
+        painter.drawImage(event.first, event.second);
+    }
+    painter.end();
+    return image;
+}
+
+static void drawGrid(QPainter* painter, const QRect& rect) {
+    for (int x = rect.left(); x <= rect.right(); x += 16) {
+        painter->drawLine(x, rect.top(), x, rect.bottom());
+    }
+    for (int y = rect.top(); y <= rect.bottom(); y += 16) {
+        painter->drawLine(rect.left(), y, rect.right(), y);
+    }
+}
+
+QImage MapImageExporter::getStitchedImage(QProgressDialog* progress, bool includeBorder) {
     // Do a breadth-first search to gather a collection of
     // all reachable maps with their relative offsets.
     QSet<QString> visited;
     QList<StitchedMap> stitchedMaps;
     QList<StitchedMap> unvisited;
-    unvisited.append(StitchedMap{ 0, 0, this->editor->map });
+    unvisited.append(StitchedMap{ 0, 0, this->editor->map, {}, QImage() });
 
     progress->setLabelText("Gathering stitched maps...");
     while (!unvisited.isEmpty()) {
         if (progress->wasCanceled()) {
-            return QPixmap();
+            return QImage();
         }
         progress->setMaximum(visited.size() + unvisited.size());
         progress->setValue(visited.size());
@@ -245,7 +379,7 @@ QPixmap MapImageExporter::getStitchedImage(QProgressDialog* progress, bool inclu
                 x += cur.map->getWidth();
                 y += offset;
             }
-            unvisited.append(StitchedMap{ x, y, connectionMap });
+            unvisited.append(StitchedMap{ x, y, connectionMap, {}, QImage() });
         }
     }
 
@@ -276,54 +410,99 @@ QPixmap MapImageExporter::getStitchedImage(QProgressDialog* progress, bool inclu
         maxY += STITCH_MODE_BORDER_DISTANCE;
     }
 
-    // Draw the maps on the full canvas, while taking
-    // their respective offsets into account.
+    QImage stitchedImage((maxX - minX) * 16, (maxY - minY) * 16, QImage::Format_ARGB32_Premultiplied);
+    if (stitchedImage.isNull()) {
+        logError(QString("Failed to allocate a %1x%2 image for the map stitch.").arg((maxX - minX) * 16).arg((maxY - minY) * 16));
+        return QImage();
+    }
+    stitchedImage.fill(Qt::transparent);
+
+    // Pixel areas of each map, and of each map with its border around it, on the full canvas.
+    int borderSize = includeBorder ? STITCH_MODE_BORDER_DISTANCE * 16 : 0;
+    QList<QRect> mapRects;
+    QList<QRect> drawnRects;
+    for (const StitchedMap& map : stitchedMaps) {
+        QRect mapRect((map.x - minX) * 16, (map.y - minY) * 16, map.map->getWidth() * 16, map.map->getHeight() * 16);
+        mapRects.append(mapRect);
+        drawnRects.append(mapRect.adjusted(-borderSize, -borderSize, borderSize, borderSize));
+    }
+
+    // Render the maps on worker threads as the bands that they overlap are reached,
+    // and draw them onto the canvas one band at a time.
     progress->setLabelText("Drawing stitched maps...");
     progress->setValue(0);
-    progress->setMaximum(stitchedMaps.size());
-    int numDrawn = 0;
-    QPixmap stitchedPixmap((maxX - minX) * 16, (maxY - minY) * 16);
-    QPainter painter(&stitchedPixmap);
-    for (StitchedMap map : stitchedMaps) {
-        if (progress->wasCanceled()) {
-            return QPixmap();
+    progress->setMaximum(stitchedMaps.size() + 1);
+    int numRendered = 0;
+    bool showCollision = this->showCollision;
+    qreal collisionOpacity = this->editor->collisionOpacity;
+    for (int bandTop = 0; bandTop < stitchedImage.height(); bandTop += stitchBandHeight) {
+        QRect band(0, bandTop, stitchedImage.width(), qMin(stitchBandHeight, stitchedImage.height() - bandTop));
+        QList<int> bandMaps;
+        QList<StitchedMap*> toRender;
+        for (int i = 0; i < stitchedMaps.length(); i++) {
+            if (!drawnRects.at(i).intersects(band))
+                continue;
+            bandMaps.append(i);
+            StitchedMap* map = &stitchedMaps[i];
+            if (map->image.isNull()) {
+                QList<Event*> events = map->map->getAllEvents();
+                this->editor->project->loadEventPixmaps(events);
+                for (Event* event : events) {
+                    if (showEventGroup(event->group()))
+                        map->events.append(qMakePair(QPoint(event->getPixelX(), event->getPixelY()), event->pixmap.toImage()));
+                }
+                toRender.append(map);
+            }
         }
-        progress->setValue(numDrawn);
-        numDrawn++;
 
-        int pixelX = (map.x - minX) * 16;
-        int pixelY = (map.y - minY) * 16;
-        if (includeBorder) {
-            pixelX -= STITCH_MODE_BORDER_DISTANCE * 16;
-            pixelY -= STITCH_MODE_BORDER_DISTANCE * 16;
+        if (!toRender.isEmpty()) {
+            QEventLoop loop;
+            QFutureWatcher<void> watcher;
+            connect(&watcher, &QFutureWatcher<void>::progressValueChanged, &loop, [=](int value) { progress->setValue(numRendered + value); });
+            connect(&watcher, &QFutureWatcher<void>::finished, &loop, &QEventLoop::quit);
+            connect(progress, &QProgressDialog::canceled, &watcher, &QFutureWatcher<void>::cancel);
+            watcher.setFuture(QtConcurrent::map(toRender, [=](StitchedMap* map) { map->image = renderStitchedMap(*map, showCollision, collisionOpacity); }));
+            loop.exec();
+            watcher.waitForFinished();
+            if (progress->wasCanceled()) {
+                return QImage();
+            }
+            numRendered += toRender.length();
+            progress->setValue(numRendered);
         }
-        QPixmap pixmap = this->getFormattedMapPixmap(map.map, false);
-        painter.drawPixmap(pixelX, pixelY, pixmap);
-    }
 
-    // When including the borders, we simply draw all the maps again
-    // without their borders, since the first pass results in maps
-    // being occluded by other map borders.
-    if (includeBorder) {
-        progress->setLabelText("Drawing stitched maps without borders...");
-        progress->setValue(0);
-        progress->setMaximum(stitchedMaps.size());
-        numDrawn = 0;
-        for (StitchedMap map : stitchedMaps) {
-            if (progress->wasCanceled()) {
-                return QPixmap();
+        QPainter painter(&stitchedImage);
+        painter.setClipRect(band);
+
+        // Draw every border before any of the maps, so that maps aren't occluded by the borders of their neighbors.
+        if (includeBorder) {
+            for (int i : bandMaps) {
+                Map* map = stitchedMaps.at(i).map;
+                map->renderBorder();
+                QBrush borderBrush(map->layout->border_image);
+                borderBrush.setTransform(QTransform::fromTranslate(mapRects.at(i).x(), mapRects.at(i).y()));
+                painter.fillRect(drawnRects.at(i), borderBrush);
+                if (showGrid)
+                    drawGrid(&painter, drawnRects.at(i));
             }
-            progress->setValue(numDrawn);
-            numDrawn++;
+        }
+        for (int i : bandMaps) {
+            painter.drawImage(mapRects.at(i).topLeft(), stitchedMaps.at(i).image);
+            if (showGrid)
+                drawGrid(&painter, mapRects.at(i).adjusted(0, 0, 1, 1));
+        }
+        painter.end();
 
-            int pixelX = (map.x - minX) * 16;
-            int pixelY = (map.y - minY) * 16;
-            QPixmap pixmapWithoutBorders = this->getFormattedMapPixmap(map.map, true);
-            painter.drawPixmap(pixelX, pixelY, pixmapWithoutBorders);
+        // Release maps that don't reach into the next band.
+        for (int i : bandMaps) {
+            if (drawnRects.at(i).bottom() < band.bottom() + 1) {
+                stitchedMaps[i].image = QImage();
+                stitchedMaps[i].events.clear();
+            }
         }
     }
 
-    return stitchedPixmap;
+    return stitchedImage;
 }
 
 void MapImageExporter::updatePreview() {
@@ -345,9 +524,9 @@ QPixmap MapImageExporter::getFormattedMapPixmap(Map* map, bool ignoreBorder) {
     QPixmap pixmap;
 
     // draw background layer / base image
-    map->render(true);
+    map->render();
     if (showCollision) {
-        map->renderCollision(editor->collisionOpacity, true);
+        map->renderCollision(editor->collisionOpacity);
         pixmap = map->collision_pixmap;
     } else {
         pixmap = map->pixmap;
@@ -355,14 +534,7 @@ QPixmap MapImageExporter::getFormattedMapPixmap(Map* map, bool ignoreBorder) {
 
     // draw events
     QPainter eventPainter(&pixmap);
-    QList<Event*> events = map->getAllEvents();
-    editor->project->loadEventPixmaps(events);
-    for (Event* event : events) {
-        QString group = event->get("event_group_type");
-        if ((showObjects && group == "object_event_group") || (showWarps && group == "warp_event_group") || (showBGs && group == "bg_event_group")
-            || (showTriggers && group == "coord_event_group") || (showHealSpots && group == "heal_event_group"))
-            eventPainter.drawImage(QPoint(event->getPixelX(), event->getPixelY()), event->pixmap.toImage());
-    }
+    paintEvents(&eventPainter, map);
     eventPainter.end();
 
     // draw map border
@@ -427,6 +599,32 @@ QPixmap MapImageExporter::getFormattedMapPixmap(Map* map, bool ignoreBorder) {
     return pixmap;
 }
 
+bool MapImageExporter::showEventGroup(Event::Group group) {
+    switch (group) {
+    case Event::Group::Object:
+        return showObjects;
+    case Event::Group::Warp:
+        return showWarps;
+    case Event::Group::Bg:
+        return showBGs;
+    case Event::Group::Coord:
+        return showTriggers;
+    case Event::Group::Heal:
+        return showHealSpots;
+    default:
+        return false;
+    }
+}
+
+void MapImageExporter::paintEvents(QPainter* painter, Map* map) {
+    QList<Event*> events = map->getAllEvents();
+    editor->project->loadEventPixmaps(events);
+    for (Event* event : events) {
+        if (showEventGroup(event->group()))
+            painter->drawImage(QPoint(event->getPixelX(), event->getPixelY()), event->pixmap.toImage());
+    }
+}
+
 void MapImageExporter::on_checkBox_Elevation_stateChanged(int state) {
     showCollision = (state == Qt::Checked);
     updatePreview();
@@ -2,6 +2,9 @@
 #include "metatile.h"
 #include "log.h"
 
+#include <QGraphicsView>
+#include <QStyleOptionGraphicsItem>
+
 #include "editcommands.h"
 
 #define SWAP(a, b)                                                                                                                                             \
@@ -83,30 +86,31 @@ void MapPixmapItem::shift(QGraphicsSceneMouseEvent* event) {
 }
 
 void MapPixmapItem::shift(int xDelta, int yDelta, bool fromScriptCall) {
-    Blockdata oldMetatiles = map->layout->blockdata;
-
-    for (int i = 0; i < map->getWidth(); i++)
-        for (int j = 0; j < map->getHeight(); j++) {
-            int destX = i + xDelta;
-            int destY = j + yDelta;
-            if (destX < 0)
-                do {
-                    destX += map->getWidth();
-                } while (destX < 0);
-            if (destY < 0)
-                do {
-                    destY += map->getHeight();
-                } while (destY < 0);
-            destX %= map->getWidth();
-            destY %= map->getHeight();
-
-            int blockIndex = j * map->getWidth() + i;
-            Block srcBlock = oldMetatiles.at(blockIndex);
-            map->setBlock(destX, destY, srcBlock);
+    int width = map->getWidth();
+    int height = map->getHeight();
+    if (width <= 0 || height <= 0)
+        return;
+
+    // Build the shifted blocks separately so the old blocks remain shared with the edit history.
+    const Blockdata oldMetatiles = map->layout->blockdata;
+    Blockdata newMetatiles = oldMetatiles;
+    int xOffset = ((xDelta % width) + width) % width;
+    int yOffset = ((yDelta % height) + height) % height;
+    for (int j = 0; j < height; j++) {
+        int destY = (j + yOffset) % height;
+        for (int i = 0; i < width; i++) {
+            int destX = (i + xOffset) % width;
+            newMetatiles[destY * width + destX] = oldMetatiles.at(j * width + i);
         }
+    }
+    map->layout->blockdata = newMetatiles;
+    map->markAllBlocksDirty();
 
-    if (!fromScriptCall && map->layout->blockdata != oldMetatiles) {
-        map->editHistory.push(new ShiftMetatiles(map, oldMetatiles, map->layout->blockdata, actionId_));
+    if (!fromScriptCall) {
+        BlockdataDiff changes(oldMetatiles, newMetatiles);
+        if (!changes.isEmpty()) {
+            map->editHistory.push(new ShiftMetatiles(map, changes, actionId_));
+        }
     }
 }
 
@@ -130,10 +134,12 @@ void MapPixmapItem::paintNormal(int x, int y, bool fromScriptCall) {
     y = initialY + (yDiff / selectionDimensions.y()) * selectionDimensions.y();
 
     // for edit history
-    Blockdata oldMetatiles = !fromScriptCall ? map->layout->blockdata : Blockdata();
+    BlockdataDiff changes;
 
-    for (int i = 0; i < selectionDimensions.x() && i + x < map->getWidth(); i++)
-        for (int j = 0; j < selectionDimensions.y() && j + y < map->getHeight(); j++) {
+    int width = map->getWidth();
+    int height = map->getHeight();
+    for (int i = 0; i < selectionDimensions.x() && i + x < width; i++)
+        for (int j = 0; j < selectionDimensions.y() && j + y < height; j++) {
             int actualX = i + x;
             int actualY = j + y;
             Block block;
@@ -144,12 +150,15 @@ void MapPixmapItem::paintNormal(int x, int y, bool fromScriptCall) {
                     block.collision = selectedCollisions->at(index).first;
                     block.elevation = selectedCollisions->at(index).second;
                 }
-                map->setBlock(actualX, actualY, block, !fromScriptCall);
+                map->setBlock(actualX, actualY, block, !fromScriptCall, &changes);
             }
         }
 
-    if (!fromScriptCall && map->layout->blockdata != oldMetatiles) {
-        map->editHistory.push(new PaintMetatile(map, oldMetatiles, map->layout->blockdata, actionId_));
+    if (!fromScriptCall) {
+        changes.compact();
+        if (!changes.isEmpty()) {
+            map->editHistory.push(new PaintMetatile(map, changes, actionId_));
+        }
     }
 }
 
@@ -198,7 +207,7 @@ void MapPixmapItem::paintSmartPath(int x, int y, bool fromScriptCall) {
     }
 
     // for edit history
-    Blockdata oldMetatiles = !fromScriptCall ? map->layout->blockdata : Blockdata();
+    BlockdataDiff changes;
 
     // Fill the region with the open tile.
     for (int i = 0; i <= 1; i++)
@@ -215,7 +224,7 @@ void MapPixmapItem::paintSmartPath(int x, int y, bool fromScriptCall) {
                     block.collision = openTileCollision;
                     block.elevation = openTileElevation;
                 }
-                map->setBlock(actualX, actualY, block, !fromScriptCall);
+                map->setBlock(actualX, actualY, block, !fromScriptCall, &changes);
             }
         }
 
@@ -258,11 +267,14 @@ void MapPixmapItem::paintSmartPath(int x, int y, bool fromScriptCall) {
                 block.collision = selectedCollisions->at(smartPathTable[id]).first;
                 block.elevation = selectedCollisions->at(smartPathTable[id]).second;
             }
-            map->setBlock(actualX, actualY, block, !fromScriptCall);
+            map->setBlock(actualX, actualY, block, !fromScriptCall, &changes);
         }
 
-    if (!fromScriptCall && map->layout->blockdata != oldMetatiles) {
-        map->editHistory.push(new PaintMetatile(map, oldMetatiles, map->layout->blockdata, actionId_));
+    if (!fromScriptCall) {
+        changes.compact();
+        if (!changes.isEmpty()) {
+            map->editHistory.push(new PaintMetatile(map, changes, actionId_));
+        }
     }
 }
 
@@ -345,12 +357,8 @@ void MapPixmapItem::updateMetatileSelection(QGraphicsSceneMouseEvent* event) {
         for (QPoint point : selection) {
             int x = point.x();
             int y = point.y();
-            Block block;
-            if (map->getBlock(x, y, &block)) {
-                metatiles.append(block.tile);
-            }
-            int blockIndex = y * map->getWidth() + x;
-            block = map->layout->blockdata.at(blockIndex);
+            Block block = map->getBlockUnchecked(x, y);
+            metatiles.append(block.tile);
             auto collision = block.collision;
             auto elevation = block.elevation;
             collisions.append(QPair<uint16_t, uint16_t>(collision, elevation));
@@ -414,13 +422,16 @@ void MapPixmapItem::magicFill(int initialX, int initialY, QPoint selectionDimens
             return;
         }
 
-        Blockdata oldMetatiles = !fromScriptCall ? map->layout->blockdata : Blockdata();
+        BlockdataDiff changes;
 
         bool setCollisions = selectedCollisions && selectedCollisions->length() == selectedMetatiles->length();
         uint16_t tile = block.tile;
-        for (int y = 0; y < map->getHeight(); y++) {
-            for (int x = 0; x < map->getWidth(); x++) {
-                if (map->getBlock(x, y, &block) && block.tile == tile) {
+        int width = map->getWidth();
+        int height = map->getHeight();
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                block = map->getBlockUnchecked(x, y);
+                if (block.tile == tile) {
                     int xDiff = x - initialX;
                     int yDiff = y - initialY;
                     int i = xDiff % selectionDimensions.x();
@@ -435,13 +446,16 @@ void MapPixmapItem::magicFill(int initialX, int initialY, QPoint selectionDimens
                         block.collision = selectedCollisions->at(index).first;
                         block.elevation = selectedCollisions->at(index).second;
                     }
-                    map->setBlock(x, y, block, !fromScriptCall);
+                    map->setBlock(x, y, block, !fromScriptCall, &changes);
                 }
             }
         }
 
-        if (!fromScriptCall && map->layout->blockdata != oldMetatiles) {
-            map->editHistory.push(new MagicFillMetatile(map, oldMetatiles, map->layout->blockdata, actionId_));
+        if (!fromScriptCall) {
+            changes.compact();
+            if (!changes.isEmpty()) {
+                map->editHistory.push(new MagicFillMetatile(map, changes, actionId_));
+            }
         }
     }
 }
@@ -462,22 +476,21 @@ void MapPixmapItem::floodFill(int initialX, int initialY, uint16_t metatileId, b
 
 void MapPixmapItem::floodFill(int initialX, int initialY, QPoint selectionDimensions, QList<uint16_t>* selectedMetatiles,
     QList<QPair<uint16_t, uint16_t>>* selectedCollisions, bool fromScriptCall) {
+    Block block;
+    if (!map->getBlock(initialX, initialY, &block))
+        return;
+
+    uint16_t oldTile = block.tile;
+    if (selectedMetatiles->count() == 1 && selectedMetatiles->at(0) == oldTile)
+        return;
+
     bool setCollisions = selectedCollisions && selectedCollisions->length() == selectedMetatiles->length();
-    Blockdata oldMetatiles = !fromScriptCall ? map->layout->blockdata : Blockdata();
-
-    QSet<int> visited;
-    QList<QPoint> todo;
-    todo.append(QPoint(initialX, initialY));
-    while (todo.length()) {
-        QPoint point = todo.takeAt(0);
-        int x = point.x();
-        int y = point.y();
-        Block block;
-        if (!map->getBlock(x, y, &block)) {
-            continue;
-        }
+    BlockdataDiff changes;
 
-        visited.insert(x + y * map->getWidth());
+    int width = map->getWidth();
+    for (int blockIndex : map->getConnectedBlocks(initialX, initialY, [oldTile](const Block& other) { return other.tile == oldTile; })) {
+        int x = blockIndex % width;
+        int y = blockIndex / width;
         int xDiff = x - initialX;
         int yDiff = y - initialY;
         int i = xDiff % selectionDimensions.x();
@@ -487,36 +500,20 @@ void MapPixmapItem::floodFill(int initialX, int initialY, QPoint selectionDimens
         if (j < 0)
             j = selectionDimensions.y() + j;
         int index = j * selectionDimensions.x() + i;
-        uint16_t tile = selectedMetatiles->at(index);
-        uint16_t old_tile = block.tile;
-        if (selectedMetatiles->count() != 1 || old_tile != tile) {
-            block.tile = tile;
-            if (setCollisions) {
-                block.collision = selectedCollisions->at(index).first;
-                block.elevation = selectedCollisions->at(index).second;
-            }
-            map->setBlock(x, y, block, !fromScriptCall);
-        }
-        if (!visited.contains(x + 1 + y * map->getWidth()) && map->getBlock(x + 1, y, &block) && block.tile == old_tile) {
-            todo.append(QPoint(x + 1, y));
-            visited.insert(x + 1 + y * map->getWidth());
-        }
-        if (!visited.contains(x - 1 + y * map->getWidth()) && map->getBlock(x - 1, y, &block) && block.tile == old_tile) {
-            todo.append(QPoint(x - 1, y));
-            visited.insert(x - 1 + y * map->getWidth());
-        }
-        if (!visited.contains(x + (y + 1) * map->getWidth()) && map->getBlock(x, y + 1, &block) && block.tile == old_tile) {
-            todo.append(QPoint(x, y + 1));
-            visited.insert(x + (y + 1) * map->getWidth());
-        }
-        if (!visited.contains(x + (y - 1) * map->getWidth()) && map->getBlock(x, y - 1, &block) && block.tile == old_tile) {
-            todo.append(QPoint(x, y - 1));
-            visited.insert(x + (y - 1) * map->getWidth());
+        block = map->getBlockUnchecked(x, y);
+        block.tile = selectedMetatiles->at(index);
+        if (setCollisions) {
+            block.collision = selectedCollisions->at(index).first;
+            block.elevation = selectedCollisions->at(index).second;
         }
+        map->setBlock(x, y, block, !fromScriptCall, &changes);
     }
 
-    if (!fromScriptCall && map->layout->blockdata != oldMetatiles) {
-        map->editHistory.push(new BucketFillMetatile(map, oldMetatiles, map->layout->blockdata, actionId_));
+    if (!fromScriptCall) {
+        changes.compact();
+        if (!changes.isEmpty()) {
+            map->editHistory.push(new BucketFillMetatile(map, changes, actionId_));
+        }
     }
 }
 
@@ -540,59 +537,34 @@ void MapPixmapItem::floodFillSmartPath(int initialX, int initialY, bool fromScri
         setCollisions = true;
     }
 
-    Blockdata oldMetatiles = !fromScriptCall ? map->layout->blockdata : Blockdata();
+    BlockdataDiff changes;
 
     // Flood fill the region with the open tile.
-    QList<QPoint> todo;
-    todo.append(QPoint(initialX, initialY));
-    while (todo.length()) {
-        QPoint point = todo.takeAt(0);
-        int x = point.x();
-        int y = point.y();
-        Block block;
-        if (!map->getBlock(x, y, &block)) {
-            continue;
-        }
-
-        uint16_t old_tile = block.tile;
-        if (old_tile == openTile) {
-            continue;
-        }
+    Block block;
+    if (!map->getBlock(initialX, initialY, &block))
+        return;
 
-        block.tile = openTile;
-        if (setCollisions) {
-            block.collision = openTileCollision;
-            block.elevation = openTileElevation;
-        }
-        map->setBlock(x, y, block, !fromScriptCall);
-        if (map->getBlock(x + 1, y, &block) && block.tile == old_tile) {
-            todo.append(QPoint(x + 1, y));
-        }
-        if (map->getBlock(x - 1, y, &block) && block.tile == old_tile) {
-            todo.append(QPoint(x - 1, y));
-        }
-        if (map->getBlock(x, y + 1, &block) && block.tile == old_tile) {
-            todo.append(QPoint(x, y + 1));
-        }
-        if (map->getBlock(x, y - 1, &block) && block.tile == old_tile) {
-            todo.append(QPoint(x, y - 1));
+    uint16_t oldTile = block.tile;
+    int width = map->getWidth();
+    if (oldTile != openTile) {
+        for (int blockIndex : map->getConnectedBlocks(initialX, initialY, [oldTile](const Block& other) { return other.tile == oldTile; })) {
+            block = map->getBlockUnchecked(blockIndex % width, blockIndex / width);
+            block.tile = openTile;
+            if (setCollisions) {
+                block.collision = openTileCollision;
+                block.elevation = openTileElevation;
+            }
+            map->setBlock(blockIndex % width, blockIndex / width, block, !fromScriptCall, &changes);
         }
     }
 
-    // Go back and resolve the flood-filled edge tiles.
-    // Mark tiles as visited while we go.
-    QSet<int> visited;
-    todo.append(QPoint(initialX, initialY));
-    while (todo.length()) {
-        QPoint point = todo.takeAt(0);
-        int x = point.x();
-        int y = point.y();
-        Block block;
-        if (!map->getBlock(x, y, &block)) {
-            continue;
-        }
-
-        visited.insert(x + y * map->getWidth());
+    // Go back and resolve the edge tiles of the connected smart path.
+    // Replacing tiles doesn't change which blocks are smart-path tiles, so the region can be found up front.
+    auto isSmartPathTile = [selectedMetatiles](const Block& other) { return IS_SMART_PATH_TILE(other); };
+    for (int blockIndex : map->getConnectedBlocks(initialX, initialY, isSmartPathTile)) {
+        int x = blockIndex % width;
+        int y = blockIndex / width;
+        block = map->getBlockUnchecked(x, y);
         int id = 0;
         Block top;
         Block right;
@@ -614,29 +586,14 @@ void MapPixmapItem::floodFillSmartPath(int initialX, int initialY, bool fromScri
             block.collision = selectedCollisions->at(smartPathTable[id]).first;
             block.elevation = selectedCollisions->at(smartPathTable[id]).second;
         }
-        map->setBlock(x, y, block, !fromScriptCall);
-
-        // Visit neighbors if they are smart-path tiles, and don't revisit any.
-        if (!visited.contains(x + 1 + y * map->getWidth()) && map->getBlock(x + 1, y, &block) && IS_SMART_PATH_TILE(block)) {
-            todo.append(QPoint(x + 1, y));
-            visited.insert(x + 1 + y * map->getWidth());
-        }
-        if (!visited.contains(x - 1 + y * map->getWidth()) && map->getBlock(x - 1, y, &block) && IS_SMART_PATH_TILE(block)) {
-            todo.append(QPoint(x - 1, y));
-            visited.insert(x - 1 + y * map->getWidth());
-        }
-        if (!visited.contains(x + (y + 1) * map->getWidth()) && map->getBlock(x, y + 1, &block) && IS_SMART_PATH_TILE(block)) {
-            todo.append(QPoint(x, y + 1));
-            visited.insert(x + (y + 1) * map->getWidth());
-        }
-        if (!visited.contains(x + (y - 1) * map->getWidth()) && map->getBlock(x, y - 1, &block) && IS_SMART_PATH_TILE(block)) {
-            todo.append(QPoint(x, y - 1));
-            visited.insert(x + (y - 1) * map->getWidth());
-        }
+        map->setBlock(x, y, block, !fromScriptCall, &changes);
     }
 
-    if (!fromScriptCall && map->layout->blockdata != oldMetatiles) {
-        map->editHistory.push(new BucketFillMetatile(map, oldMetatiles, map->layout->blockdata, actionId_));
+    if (!fromScriptCall) {
+        changes.compact();
+        if (!changes.isEmpty()) {
+            map->editHistory.push(new BucketFillMetatile(map, changes, actionId_));
+        }
     }
 }
 
@@ -683,8 +640,110 @@ void MapPixmapItem::select(QGraphicsSceneMouseEvent* event) {
 void MapPixmapItem::draw(bool ignoreCache) {
     if (map) {
         map->setMapItem(this);
-        setPixmap(map->render(ignoreCache));
+        updateChunks(map->takeDirtyMetatileRect(), ignoreCache);
+    }
+}
+
+void MapPixmapItem::updateChunks(const QRect& dirtyBlocks, bool ignoreCache) {
+    QSize mapSize(map->getWidth(), map->getHeight());
+    if (ignoreCache || mapSize != chunksMapSize) {
+        prepareGeometryChange();
+        chunks.clear();
+        chunksMapSize = mapSize;
+        update();
+        return;
+    }
+    if (dirtyBlocks.isEmpty()) {
+        return;
+    }
+
+    // Patch the dirty blocks into any chunks that are already rendered. The rest are rendered when they are next painted.
+    int chunksPerRow = (map->getWidth() + chunkSize - 1) / chunkSize;
+    for (int chunkY = dirtyBlocks.top() / chunkSize; chunkY <= dirtyBlocks.bottom() / chunkSize; chunkY++) {
+        for (int chunkX = dirtyBlocks.left() / chunkSize; chunkX <= dirtyBlocks.right() / chunkSize; chunkX++) {
+            auto it = chunks.find(chunkY * chunksPerRow + chunkX);
+            if (it == chunks.end())
+                continue;
+            QRect chunkBlocks(chunkX * chunkSize, chunkY * chunkSize, chunkSize, chunkSize);
+            QPainter painter(&it.value());
+            painter.translate(-chunkBlocks.x() * 16, -chunkBlocks.y() * 16);
+            paintBlocks(&painter, dirtyBlocks & chunkBlocks);
+            painter.end();
+        }
+    }
+    update(QRectF(dirtyBlocks.x() * 16, dirtyBlocks.y() * 16, dirtyBlocks.width() * 16, dirtyBlocks.height() * 16));
+}
+
+void MapPixmapItem::paintBlocks(QPainter* painter, const QRect& blockRect) {
+    map->paintBlocks(painter, blockRect);
+}
+
+QPixmap MapPixmapItem::getChunk(int chunkX, int chunkY) {
+    int chunksPerRow = (map->getWidth() + chunkSize - 1) / chunkSize;
+    int key = chunkY * chunksPerRow + chunkX;
+    auto it = chunks.constFind(key);
+    if (it != chunks.constEnd())
+        return it.value();
+
+    QRect chunkBlocks = QRect(chunkX * chunkSize, chunkY * chunkSize, chunkSize, chunkSize) & QRect(0, 0, map->getWidth(), map->getHeight());
+    QPixmap chunk(chunkBlocks.width() * 16, chunkBlocks.height() * 16);
+    chunk.fill(Qt::transparent);
+    QPainter painter(&chunk);
+    painter.translate(-chunkBlocks.x() * 16, -chunkBlocks.y() * 16);
+    paintBlocks(&painter, chunkBlocks);
+    painter.end();
+    chunks.insert(key, chunk);
+    return chunk;
+}
+
+void MapPixmapItem::evictChunks(const QRect& keepRect) {
+    int chunksPerRow = (map->getWidth() + chunkSize - 1) / chunkSize;
+    int chunkPixels = chunkSize * 16;
+    for (auto it = chunks.begin(); it != chunks.end();) {
+        QRect chunkRect((it.key() % chunksPerRow) * chunkPixels, (it.key() / chunksPerRow) * chunkPixels, chunkPixels, chunkPixels);
+        if (chunkRect.intersects(keepRect)) {
+            ++it;
+        } else {
+            it = chunks.erase(it);
+        }
+    }
+}
+
+QRectF MapPixmapItem::boundingRect() const {
+    if (!map)
+        return QRectF();
+    return QRectF(0, 0, map->getWidth() * 16, map->getHeight() * 16);
+}
+
+QPainterPath MapPixmapItem::shape() const {
+    QPainterPath path;
+    path.addRect(boundingRect());
+    return path;
+}
+
+void MapPixmapItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) {
+    if (!map || !map->getWidth() || !map->getHeight())
+        return;
+
+    QRect exposed = option->exposedRect.toAlignedRect() & boundingRect().toAlignedRect();
+    if (!exposed.isEmpty()) {
+        int chunkPixels = chunkSize * 16;
+        for (int chunkY = exposed.top() / chunkPixels; chunkY <= exposed.bottom() / chunkPixels; chunkY++) {
+            for (int chunkX = exposed.left() / chunkPixels; chunkX <= exposed.right() / chunkPixels; chunkX++) {
+                painter->drawPixmap(chunkX * chunkPixels, chunkY * chunkPixels, getChunk(chunkX, chunkY));
+            }
+        }
+    }
+
+    // Keep the chunks around the visible part of the view, and drop everything further away.
+    QRect visible = exposed;
+    QGraphicsView* view = widget ? qobject_cast<QGraphicsView*>(widget->parentWidget()) : nullptr;
+    if (view) {
+        QRectF visibleScene = view->mapToScene(view->viewport()->rect()).boundingRect();
+        visible = mapRectFromScene(visibleScene).toAlignedRect();
     }
+    int margin = chunkSize * 16;
+    evictChunks(visible.adjusted(-margin, -margin, margin, margin));
 }
 
 void MapPixmapItem::hoverMoveEvent(QGraphicsSceneHoverEvent* event) {
@@ -87,8 +87,8 @@ void NewMapPopup::setDefaultValues(int groupNum, QString mapSec) {
     ui->comboBox_NewMap_Group->setCurrentText(project->groupNames.at(groupNum));
 
     if (existingLayout) {
-        ui->spinBox_NewMap_Width->setValue(project->mapLayouts.value(layoutId)->width.toInt(nullptr, 0));
-        ui->spinBox_NewMap_Height->setValue(project->mapLayouts.value(layoutId)->height.toInt(nullptr, 0));
+        ui->spinBox_NewMap_Width->setValue(project->mapLayouts.value(layoutId)->width);
+        ui->spinBox_NewMap_Height->setValue(project->mapLayouts.value(layoutId)->height);
         ui->comboBox_NewMap_Primary_Tileset->setCurrentText(project->mapLayouts.value(layoutId)->tileset_primary_label);
         ui->comboBox_NewMap_Secondary_Tileset->setCurrentText(project->mapLayouts.value(layoutId)->tileset_secondary_label);
         ui->spinBox_NewMap_Width->setDisabled(true);
@@ -202,14 +202,14 @@ void NewMapPopup::on_pushButton_NewMap_Accept_clicked() {
         layout = new MapLayout;
         layout->id = MapLayout::layoutConstantFromName(newMapName);
         layout->name = QString("%1_Layout").arg(newMap->name);
-        layout->width = QString::number(this->ui->spinBox_NewMap_Width->value());
-        layout->height = QString::number(this->ui->spinBox_NewMap_Height->value());
+        layout->width = this->ui->spinBox_NewMap_Width->value();
+        layout->height = this->ui->spinBox_NewMap_Height->value();
         if (projectConfig.getUseCustomBorderSize()) {
-            layout->border_width = QString::number(this->ui->spinBox_NewMap_BorderWidth->value());
-            layout->border_height = QString::number(this->ui->spinBox_NewMap_BorderHeight->value());
+            layout->border_width = this->ui->spinBox_NewMap_BorderWidth->value();
+            layout->border_height = this->ui->spinBox_NewMap_BorderHeight->value();
         } else {
-            layout->border_width = QString::number(DEFAULT_BORDER_WIDTH);
-            layout->border_height = QString::number(DEFAULT_BORDER_HEIGHT);
+            layout->border_width = DEFAULT_BORDER_WIDTH;
+            layout->border_height = DEFAULT_BORDER_HEIGHT;
         }
         layout->tileset_primary_label = this->ui->comboBox_NewMap_Primary_Tileset->currentText();
         layout->tileset_secondary_label = this->ui->comboBox_NewMap_Secondary_Tileset->currentText();
@@ -1,5 +1,11 @@
 #include "overlay.h"
 
+#include <QFileInfo>
+#include <QDateTime>
+#include <QFontMetrics>
+#include <QtMath>
+#include <algorithm>
+
 void OverlayText::render(QPainter* painter) {
     QFont font = painter->font();
     font.setPixelSize(this->fontSize);
@@ -8,6 +14,14 @@ void OverlayText::render(QPainter* painter) {
     painter->drawText(this->x, this->y, this->text);
 }
 
+QRect OverlayText::boundingRect() const {
+    // The painter's font family isn't known yet, so leave some room for a wider one.
+    QFont font;
+    font.setPixelSize(this->fontSize);
+    int margin = this->fontSize / 2 + 1;
+    return QFontMetrics(font).boundingRect(this->text).translated(this->x, this->y).adjusted(-margin, -margin, margin, margin);
+}
+
 void OverlayRect::render(QPainter* painter) {
     if (this->filled) {
         painter->fillRect(this->x, this->y, this->width, this->height, this->color);
@@ -17,29 +31,151 @@ void OverlayRect::render(QPainter* painter) {
     }
 }
 
+QRect OverlayRect::boundingRect() const {
+    QRect rect = QRect(this->x, this->y, this->width, this->height).normalized();
+    if (!this->filled) {
+        // The outline is drawn one pixel past the rect's right and bottom edges.
+        rect.adjust(-1, -1, 1, 1);
+    }
+    return rect;
+}
+
 void OverlayImage::render(QPainter* painter) {
     painter->drawImage(this->x, this->y, this->image);
 }
 
+QRect OverlayImage::boundingRect() const {
+    return QRect(QPoint(this->x, this->y), this->image.size());
+}
+
+// Images are decoded once per file and shared by every item that shows them.
+// The cache is bounded by the images' size in KB, so scripts that load many images don't hold on to them all.
+static QImage loadOverlayImage(const QString& filepath) {
+    struct CachedImage {
+        QDateTime lastModified;
+        QImage image;
+    };
+    static QCache<QString, CachedImage> cache(64 * 1024);
+
+    QDateTime lastModified = QFileInfo(filepath).lastModified();
+    CachedImage* cached = cache.object(filepath);
+    if (cached && cached->lastModified == lastModified) {
+        return cached->image;
+    }
+    QImage image(filepath);
+    int cost = qMax(image.bytesPerLine() * image.height() / 1024, 1);
+    cache.insert(filepath, new CachedImage{ lastModified, image }, cost);
+    return image;
+}
+
 void Overlay::clearItems() {
     for (auto item : this->items) {
         delete item;
     }
     this->items.clear();
+    this->itemBounds.clear();
+    this->cellItems.clear();
+    this->cellPixmaps.clear();
 }
 
 QList<OverlayItem*> Overlay::getItems() {
     return this->items;
 }
 
-void Overlay::addText(QString text, int x, int y, QString color, int fontSize) {
-    this->items.append(new OverlayText(text, x, y, QColor(color), fontSize));
+QRect Overlay::addText(QString text, int x, int y, QString color, int fontSize) {
+    return this->addItem(new OverlayText(text, x, y, QColor(color), fontSize));
+}
+
+QRect Overlay::addRect(int x, int y, int width, int height, QString color, bool filled) {
+    return this->addItem(new OverlayRect(x, y, width, height, QColor(color), filled));
+}
+
+QRect Overlay::addImage(int x, int y, QString filepath) {
+    return this->addItem(new OverlayImage(x, y, loadOverlayImage(filepath)));
+}
+
+quint64 Overlay::cellKey(int column, int row) {
+    return (static_cast<quint64>(static_cast<quint32>(column)) << 32) | static_cast<quint32>(row);
+}
+
+// The columns and rows of the cells that rect touches, as a rect of cell coordinates.
+QRect Overlay::cellRange(const QRect& rect) const {
+    int left = qFloor(rect.left() / static_cast<qreal>(cellSize));
+    int top = qFloor(rect.top() / static_cast<qreal>(cellSize));
+    int right = qFloor(rect.right() / static_cast<qreal>(cellSize));
+    int bottom = qFloor(rect.bottom() / static_cast<qreal>(cellSize));
+    return QRect(QPoint(left, top), QPoint(right, bottom));
 }
 
-void Overlay::addRect(int x, int y, int width, int height, QString color, bool filled) {
-    this->items.append(new OverlayRect(x, y, width, height, QColor(color), filled));
+QRect Overlay::addItem(OverlayItem* item) {
+    int index = this->items.length();
+    QRect bounds = item->boundingRect();
+    this->items.append(item);
+    this->itemBounds.append(bounds);
+    if (bounds.isEmpty())
+        return bounds;
+
+    QRect cells = this->cellRange(bounds);
+    for (int row = cells.top(); row <= cells.bottom(); row++) {
+        for (int column = cells.left(); column <= cells.right(); column++) {
+            quint64 key = cellKey(column, row);
+            this->cellItems[key].append(index);
+            this->cellPixmaps.remove(key);
+        }
+    }
+    return bounds;
 }
 
-void Overlay::addImage(int x, int y, QString filepath) {
-    this->items.append(new OverlayImage(x, y, QImage(filepath)));
+void Overlay::render(QPainter* painter, const QRectF& exposedRect) {
+    if (this->cellItems.isEmpty())
+        return;
+
+    QRect exposed = exposedRect.toAlignedRect();
+    QRect cells = this->cellRange(exposed);
+    qreal scale = painter->transform().m11() * painter->device()->devicePixelRatioF();
+
+    painter->save();
+    if (scale > 1.0) {
+        // Pixmaps would look blurry when zoomed in, so draw the visible items directly.
+        QList<int> visible;
+        for (int row = cells.top(); row <= cells.bottom(); row++) {
+            for (int column = cells.left(); column <= cells.right(); column++) {
+                auto it = this->cellItems.constFind(cellKey(column, row));
+                if (it != this->cellItems.constEnd())
+                    visible.append(it.value());
+            }
+        }
+        std::sort(visible.begin(), visible.end());
+        visible.erase(std::unique(visible.begin(), visible.end()), visible.end());
+        for (int index : visible) {
+            if (this->itemBounds.at(index).intersects(exposed))
+                this->items.at(index)->render(painter);
+        }
+    } else {
+        for (int row = cells.top(); row <= cells.bottom(); row++) {
+            for (int column = cells.left(); column <= cells.right(); column++) {
+                quint64 key = cellKey(column, row);
+                auto it = this->cellItems.constFind(key);
+                if (it == this->cellItems.constEnd())
+                    continue;
+
+                QPoint origin(column * cellSize, row * cellSize);
+                QPixmap* pixmap = this->cellPixmaps.object(key);
+                if (!pixmap) {
+                    pixmap = new QPixmap(cellSize, cellSize);
+                    pixmap->fill(Qt::transparent);
+                    QPainter cellPainter(pixmap);
+                    cellPainter.setFont(painter->font());
+                    cellPainter.translate(-origin);
+                    for (int index : it.value()) {
+                        this->items.at(index)->render(&cellPainter);
+                    }
+                    cellPainter.end();
+                    this->cellPixmaps.insert(key, pixmap, cellSize * cellSize * 4 / 1024);
+                }
+                painter->drawPixmap(origin, *pixmap);
+            }
+        }
+    }
+    painter->restore();
 }
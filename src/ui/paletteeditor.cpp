@@ -198,6 +198,7 @@ void PaletteEditor::setColor(int colorIndex) {
     Tileset* tileset = paletteNum < Project::getNumPalettesPrimary() ? this->primaryTileset : this->secondaryTileset;
     tileset->palettes[paletteNum][colorIndex] = qRgb(red, green, blue);
     tileset->palettePreviews[paletteNum][colorIndex] = qRgb(red, green, blue);
+    tileset->markChanged();
     this->refreshColor(colorIndex);
     this->commitEditHistory(paletteNum);
     emit this->changedPaletteColor();
@@ -253,6 +254,8 @@ void PaletteEditor::setColorsFromHistory(PaletteHistoryItem* history, int palett
             this->secondaryTileset->palettePreviews[paletteId][i] = history->colors.at(i);
         }
     }
+    this->primaryTileset->markChanged();
+    this->secondaryTileset->markChanged();
 
     this->refreshColorSliders();
     this->refreshColors();
@@ -300,6 +303,8 @@ void PaletteEditor::on_actionImport_Palette_triggered() {
             this->secondaryTileset->palettePreviews[paletteId][i] = palette.at(i);
         }
     }
+    this->primaryTileset->markChanged();
+    this->secondaryTileset->markChanged();
 
     this->refreshColorSliders();
     this->refreshColors();
@@ -36,6 +36,8 @@ void PreferenceEditor::populateFields() {
     ui->lineEdit_TextEditorOpenFolder->setText(porymapConfig.getTextEditorOpenFolder());
 
     ui->lineEdit_TextEditorGotoLine->setText(porymapConfig.getTextEditorGotoLine());
+
+    ui->spinBox_CacheBudget->setValue(porymapConfig.getCacheBudgetMB());
 }
 
 void PreferenceEditor::saveFields() {
@@ -49,6 +51,8 @@ void PreferenceEditor::saveFields() {
 
     porymapConfig.setTextEditorGotoLine(ui->lineEdit_TextEditorGotoLine->text());
 
+    porymapConfig.setCacheBudgetMB(ui->spinBox_CacheBudget->value());
+
     emit preferencesSaved();
 }
 
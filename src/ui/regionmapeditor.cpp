@@ -471,9 +471,10 @@ void RegionMapEditor::mouseEvent_region_map(QGraphicsSceneMouseEvent* event, Reg
                     RegionMapEditorBox::BackgroundImage, this->region_map->getTiles(), this->region_map->width(), this->region_map->height());
                 history.push(commit);
             }
+            // The layout tab shows the same tiles; it only needs updating once per stroke.
+            this->region_map_layout_item->draw();
         } else {
             item->paint(event);
-            this->region_map_layout_item->draw();
             this->hasUnsavedChanges = true;
         }
     }
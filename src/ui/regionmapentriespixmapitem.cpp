@@ -22,7 +22,6 @@ void RegionMapEntriesPixmapItem::draw() {
 
     QPainter painter(&image);
     for (int i = 0; i < region_map->map_squares.size(); i++) {
-        QImage bottom_img = this->tile_selector->tileImg(region_map->map_squares[i].tile_img_id);
         QImage top_img(8, 8, QImage::Format_RGBA8888);
         int x = i % region_map->width();
         int y = i / region_map->width();
@@ -43,7 +42,7 @@ void RegionMapEntriesPixmapItem::draw() {
         }
         QPoint pos = QPoint(x * 8, y * 8);
         painter.setOpacity(1);
-        painter.drawImage(pos, bottom_img);
+        this->tile_selector->paintTile(&painter, pos, region_map->map_squares[i].tile_img_id);
         painter.save();
         painter.setOpacity(0.55);
         painter.drawImage(pos, top_img);
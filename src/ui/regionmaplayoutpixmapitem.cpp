@@ -8,7 +8,6 @@ void RegionMapLayoutPixmapItem::draw() {
 
     QPainter painter(&image);
     for (int i = 0; i < region_map->map_squares.size(); i++) {
-        QImage bottom_img = this->tile_selector->tileImg(region_map->map_squares[i].tile_img_id);
         QImage top_img(8, 8, QImage::Format_RGBA8888);
         if (region_map->map_squares[i].has_map) {
             top_img.fill(Qt::gray);
@@ -19,7 +18,7 @@ void RegionMapLayoutPixmapItem::draw() {
         int y = i / region_map->width();
         QPoint pos = QPoint(x * 8, y * 8);
         painter.setOpacity(1);
-        painter.drawImage(pos, bottom_img);
+        this->tile_selector->paintTile(&painter, pos, region_map->map_squares[i].tile_img_id);
         painter.save();
         painter.setOpacity(0.55);
         painter.drawImage(pos, top_img);
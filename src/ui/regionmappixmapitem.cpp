@@ -4,21 +4,40 @@ void RegionMapPixmapItem::draw() {
     if (!region_map)
         return;
 
-    QImage image(region_map->width() * 8, region_map->height() * 8, QImage::Format_RGBA8888);
+    QImage image(region_map->width() * 8, region_map->height() * 8, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
 
     QPainter painter(&image);
     for (int i = 0; i < region_map->map_squares.size(); i++) {
-        QImage img = this->tile_selector->tileImg(region_map->map_squares[i].tile_img_id);
         int x = i % region_map->width();
         int y = i / region_map->width();
-        QPoint pos = QPoint(x * 8, y * 8);
-        painter.drawImage(pos, img);
+        this->tile_selector->paintTile(&painter, QPoint(x * 8, y * 8), region_map->map_squares[i].tile_img_id);
     }
     painter.end();
 
     this->setPixmap(QPixmap::fromImage(image));
 }
 
+void RegionMapPixmapItem::drawSquare(int index) {
+    if (!region_map || index < 0 || index >= region_map->map_squares.size())
+        return;
+    if (this->pixmap().size() != QSize(region_map->width() * 8, region_map->height() * 8)) {
+        draw();
+        return;
+    }
+
+    // Release the item's reference first so that painting doesn't copy the whole pixmap.
+    QPixmap pixmap = this->pixmap();
+    this->setPixmap(QPixmap());
+    QPainter painter(&pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    int x = index % region_map->width();
+    int y = index / region_map->width();
+    this->tile_selector->paintTile(&painter, QPoint(x * 8, y * 8), region_map->map_squares[index].tile_img_id);
+    painter.end();
+    this->setPixmap(pixmap);
+}
+
 void RegionMapPixmapItem::paint(QGraphicsSceneMouseEvent* event) {
     if (region_map) {
         QPointF pos = event->pos();
@@ -26,7 +45,7 @@ void RegionMapPixmapItem::paint(QGraphicsSceneMouseEvent* event) {
         int y = static_cast<int>(pos.y()) / 8;
         int index = x + y * region_map->width();
         this->region_map->map_squares[index].tile_img_id = this->tile_selector->selectedTile;
-        draw();
+        drawSquare(index);
     }
 }
 
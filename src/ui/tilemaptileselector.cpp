@@ -1,6 +1,7 @@
 #include "tilemaptileselector.h"
 
 #include <QDebug>
+#include <QPainter>
 
 void TilemapTileSelector::draw() {
     size_t width_ = this->tilemap.width();
@@ -44,7 +45,12 @@ QPoint TilemapTileSelector::getTileIdCoords(unsigned tileId) {
 
 QImage TilemapTileSelector::tileImg(unsigned tileId) {
     QPoint pos = getTileIdCoords(tileId);
-    return this->tilemap.copy(pos.x() * 8, pos.y() * 8, 8, 8).toImage();
+    return this->tileAtlas.copy(pos.x() * 8, pos.y() * 8, 8, 8);
+}
+
+void TilemapTileSelector::paintTile(QPainter* painter, const QPoint& pos, unsigned tileId) {
+    QPoint coords = getTileIdCoords(tileId);
+    painter->drawImage(pos, this->tileAtlas, QRect(coords.x() * 8, coords.y() * 8, 8, 8));
 }
 
 void TilemapTileSelector::mousePressEvent(QGraphicsSceneMouseEvent* event) {
@@ -367,6 +367,7 @@ void TilesetEditor::onMetatileLayerTileChanged(int x, int y) {
         }
     }
 
+    Tileset::getBlockTileset(this->metatileSelector->getSelectedMetatile(), this->primaryTileset, this->secondaryTileset)->markChanged();
     this->metatileSelector->draw();
     this->metatileLayersItem->draw();
     this->hasUnsavedChanges = true;
@@ -700,6 +701,8 @@ void TilesetEditor::on_actionChange_Metatiles_Count_triggered() {
             this->secondaryTileset->metatiles.append(metatile);
         }
 
+        this->primaryTileset->markChanged();
+        this->secondaryTileset->markChanged();
         this->metatileSelector->updateSelectedMetatile();
         this->refresh();
         this->hasUnsavedChanges = true;
@@ -744,6 +747,7 @@ void TilesetEditor::on_actionUndo_triggered() {
     if (temp) {
         this->metatile = temp;
         *this->metatile = *prev;
+        Tileset::getBlockTileset(commit->metatileId, this->primaryTileset, this->secondaryTileset)->markChanged();
         this->metatileSelector->select(commit->metatileId);
         this->metatileSelector->draw();
         this->metatileLayersItem->draw();
@@ -763,6 +767,7 @@ void TilesetEditor::on_actionRedo_triggered() {
     if (temp) {
         this->metatile = temp;
         *this->metatile = *next;
+        Tileset::getBlockTileset(commit->metatileId, this->primaryTileset, this->secondaryTileset)->markChanged();
         this->metatileSelector->select(commit->metatileId);
         this->metatileSelector->draw();
         this->metatileLayersItem->draw();
@@ -835,7 +840,9 @@ void TilesetEditor::importTilesetMetatiles(Tileset* tileset, bool primary) {
         metatileHistory.push(commit);
     }
 
+    qDeleteAll(tileset->metatiles);
     tileset->metatiles = metatiles;
+    tileset->markChanged();
     this->refresh();
     this->hasUnsavedChanges = true;
 }
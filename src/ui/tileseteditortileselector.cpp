@@ -18,8 +18,8 @@ void TilesetEditorTileSelector::draw() {
     }
 
     int totalTiles = Project::getNumTilesTotal();
-    int primaryLength = this->primaryTileset->tiles.length();
-    int secondaryLength = this->secondaryTileset->tiles.length();
+    int primaryLength = this->primaryTileset->tileCount();
+    int secondaryLength = this->secondaryTileset->tileCount();
     int height = totalTiles / this->numTilesWide;
     QList<QRgb> palette = Tileset::getPalette(this->paletteId, this->primaryTileset, this->secondaryTileset, true);
     QImage image(this->numTilesWide * 16, height * 16, QImage::Format_RGBA8888);
@@ -220,7 +220,7 @@ QImage TilesetEditorTileSelector::buildPrimaryTilesIndexedImage() {
         return QImage();
     }
 
-    int primaryLength = this->primaryTileset->tiles.length();
+    int primaryLength = this->primaryTileset->tileCount();
     int height = qCeil(primaryLength / static_cast<double>(this->numTilesWide));
     QImage image(this->numTilesWide * 8, height * 8, QImage::Format_RGBA8888);
 
@@ -255,7 +255,7 @@ QImage TilesetEditorTileSelector::buildSecondaryTilesIndexedImage() {
         return QImage();
     }
 
-    int secondaryLength = this->secondaryTileset->tiles.length();
+    int secondaryLength = this->secondaryTileset->tileCount();
     int height = qCeil(secondaryLength / static_cast<double>(this->numTilesWide));
     QImage image(this->numTilesWide * 8, height * 8, QImage::Format_RGBA8888);
 
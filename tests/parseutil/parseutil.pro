@@ -0,0 +1,18 @@
+# Regression tests for ParseUtil. Build and run from this directory with:
+#   qmake parseutil.pro && make check
+
+QT       += core gui widgets testlib
+CONFIG   += testcase
+CONFIG   -= app_bundle
+
+TARGET = tst_parseutil
+TEMPLATE = app
+QMAKE_CXXFLAGS += -std=c++11 -Wall
+
+SOURCES += tst_parseutil.cpp \
+    ../../src/core/parseutil.cpp \
+    ../../src/log.cpp
+
+INCLUDEPATH += ../../include
+INCLUDEPATH += ../../include/core
+INCLUDEPATH += ../../include/lib
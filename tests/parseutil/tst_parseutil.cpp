@@ -0,0 +1,52 @@
+#include "parseutil.h"
+
+#include <QtTest>
+
+class TestParseUtil : public QObject {
+    Q_OBJECT
+
+private slots:
+    void evaluateDefine_data();
+    void evaluateDefine();
+};
+
+void TestParseUtil::evaluateDefine_data() {
+    QTest::addColumn<QString>("expression");
+    QTest::addColumn<int>("expected");
+
+    QTest::newRow("number") << "5" << 5;
+    QTest::newRow("hex with suffix") << "0x10UL" << 16;
+    QTest::newRow("precedence") << "1 + 2 * 3" << 7;
+    QTest::newRow("shift") << "(1 << 3) | 1" << 9;
+    QTest::newRow("known symbol") << "KNOWN + 1" << 3;
+
+    // Casts are skipped, leaving the value they wrap.
+    QTest::newRow("cast") << "((u16)5)" << 5;
+    QTest::newRow("cast with spaces") << "( unsigned int ) 7" << 7;
+    QTest::newRow("cast of expression") << "(u16)(1 << 3)" << 8;
+    QTest::newRow("cast of symbol") << "(u8)KNOWN" << 2;
+    QTest::newRow("cast of negative") << "(s8)-1" << -1;
+    QTest::newRow("cast in expression") << "(u16)4 + (u16)KNOWN" << 6;
+    QTest::newRow("parenthesized symbol") << "(KNOWN) + 1" << 3;
+
+    // Unknown identifiers next to an operand are ignored.
+    QTest::newRow("unknown before operand") << "FOO 5" << 5;
+    QTest::newRow("unknown after operand") << "5 FOO" << 5;
+    QTest::newRow("unknown macro call") << "FOO(KNOWN + 1)" << 3;
+    QTest::newRow("unknown alone") << "FOO" << 0;
+    QTest::newRow("unknown in expression") << "FOO + 1" << 1;
+}
+
+void TestParseUtil::evaluateDefine() {
+    QFETCH(QString, expression);
+    QFETCH(int, expected);
+
+    QHash<QString, int> knownDefines;
+    knownDefines.insert("KNOWN", 2);
+
+    ParseUtil parser;
+    QCOMPARE(parser.evaluateDefine(expression, knownDefines), expected);
+}
+
+QTEST_GUILESS_MAIN(TestParseUtil)
+#include "tst_parseutil.moc"